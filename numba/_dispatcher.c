@@ -8,6 +8,55 @@
 #include "_typeof.h"
 #include "frameobject.h"
 
+/* PEP 590 vectorcall is available (provisionally) from Python 3.8 */
+#if (PY_MAJOR_VERSION >= 3) && (PY_MINOR_VERSION >= 8)
+    #define NUMBA_HAVE_VECTORCALL 1
+    #ifndef Py_TPFLAGS_HAVE_VECTORCALL
+        #define Py_TPFLAGS_HAVE_VECTORCALL _Py_TPFLAGS_HAVE_VECTORCALL
+    #endif
+#else
+    #define NUMBA_HAVE_VECTORCALL 0
+#endif
+
+/* The clock used to time calls: the TSC where available */
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define NUMBA_HAVE_TSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && \
+      (defined(__x86_64__) || defined(__i386__))
+    #include <x86intrin.h>
+    #define NUMBA_HAVE_TSC 1
+#else
+    #define NUMBA_HAVE_TSC 0
+#endif
+
+/* Ticks of an arbitrary-frequency clock; dispatcher.py calibrates it */
+static unsigned long long
+read_clock(void)
+{
+#if NUMBA_HAVE_TSC
+    return __rdtsc();
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (unsigned long long) clock();
+#endif
+}
+
+/* Call statistics of a compiled overload (see Dispatcher.call_stats()) */
+#define CALL_STATS_NBINS 64
+
+typedef struct {
+    /* Borrowed reference, like the dispatcher's overloads */
+    PyObject *cfunc;
+    unsigned long long calls;
+    unsigned long long total_ticks;
+    /* Bin i counts the calls which took [2**i, 2**(i+1)) ticks */
+    unsigned long long histogram[CALL_STATS_NBINS];
+} call_stats_t;
+
 /*
  * The following call_trace and call_trace_protected functions
  * as well as the C_TRACE macro are taken from ceval.c
@@ -111,10 +160,21 @@ typedef struct DispatcherObject{
     int fold_args;
     /* Whether the last positional argument is a stararg */
     int has_stararg;
-    /* Tuple of argument names */
+    /* Tuple of (interned) argument names */
     PyObject *argnames;
+    /* Dict of argument names to positions, for non-interned keywords */
+    PyObject *argpos;
     /* Tuple of default values */
     PyObject *defargs;
+    /* First and last parameter with a default value */
+    Py_ssize_t first_def, last_def;
+    /* Whether to collect call statistics, and those collected */
+    char collect_stats;
+    call_stats_t *call_stats;
+    Py_ssize_t n_call_stats;
+#if NUMBA_HAVE_VECTORCALL
+    vectorcallfunc vectorcall;
+#endif
 } DispatcherObject;
 
 
@@ -129,12 +189,20 @@ static void
 Dispatcher_dealloc(DispatcherObject *self)
 {
     Py_XDECREF(self->argnames);
+    Py_XDECREF(self->argpos);
     Py_XDECREF(self->defargs);
+    PyMem_Free(self->call_stats);
     dispatcher_del(self->dispatcher);
     Py_TYPE(self)->tp_free((PyObject*)self);
 }
 
 
+#if NUMBA_HAVE_VECTORCALL
+static PyObject *
+Dispatcher_vectorcall(PyObject *callable, PyObject *const *stack,
+                      size_t nargsf, PyObject *kwnames);
+#endif
+
 static int
 Dispatcher_init(DispatcherObject *self, PyObject *args, PyObject *kwds)
 {
@@ -144,19 +212,49 @@ Dispatcher_init(DispatcherObject *self, PyObject *args, PyObject *kwds)
     int can_fallback;
     int has_stararg = 0;
     int exact_match_required = 0;
+    PyObject *argnames, *defargs;
+    Py_ssize_t i, nargnames;
 
     if (!PyArg_ParseTuple(args, "OiiO!O!i|ii", &tmaddrobj, &argct,
                           &self->fold_args,
-                          &PyTuple_Type, &self->argnames,
-                          &PyTuple_Type, &self->defargs,
+                          &PyTuple_Type, &argnames,
+                          &PyTuple_Type, &defargs,
                           &can_fallback,
                           &has_stararg,
                           &exact_match_required
                          )) {
         return -1;
     }
-    Py_INCREF(self->argnames);
-    Py_INCREF(self->defargs);
+    /* Own the reference before any error path, dealloc releases it */
+    Py_INCREF(defargs);
+    Py_XSETREF(self->defargs, defargs);
+    /* Precompute what is needed to fold named arguments: interned
+       names (so that keywords usually match by identity), a fallback
+       name -> position mapping, and the range of default values. */
+    nargnames = PyTuple_GET_SIZE(argnames);
+    self->argnames = PyTuple_New(nargnames);
+    self->argpos = PyDict_New();
+    if (!self->argnames || !self->argpos)
+        return -1;
+    for (i = 0; i < nargnames; i++) {
+        PyObject *name = PyTuple_GET_ITEM(argnames, i);
+        PyObject *pos;
+        if (!PyUnicode_CheckExact(name)) {
+            PyErr_SetString(PyExc_TypeError, "argument names must be str");
+            return -1;
+        }
+        Py_INCREF(name);
+        PyUnicode_InternInPlace(&name);
+        PyTuple_SET_ITEM(self->argnames, i, name);
+        pos = PyLong_FromSsize_t(i);
+        if (!pos || PyDict_SetItem(self->argpos, name, pos)) {
+            Py_XDECREF(pos);
+            return -1;
+        }
+        Py_DECREF(pos);
+    }
+    self->last_def = (has_stararg) ? nargnames - 2 : nargnames - 1;
+    self->first_def = self->last_def - PyTuple_GET_SIZE(self->defargs) + 1;
     tmaddr = PyLong_AsVoidPtr(tmaddrobj);
     self->dispatcher = dispatcher_new(tmaddr, argct);
     self->can_compile = 1;
@@ -166,6 +264,12 @@ Dispatcher_init(DispatcherObject *self, PyObject *args, PyObject *kwds)
     self->interpdef = NULL;
     self->has_stararg = has_stararg;
     self->exact_match_required = exact_match_required;
+    self->collect_stats = 0;
+    self->call_stats = NULL;
+    self->n_call_stats = 0;
+#if NUMBA_HAVE_VECTORCALL
+    self->vectorcall = Dispatcher_vectorcall;
+#endif
     return 0;
 }
 
@@ -173,9 +277,92 @@ static PyObject *
 Dispatcher_clear(DispatcherObject *self, PyObject *args)
 {
     dispatcher_clear(self->dispatcher);
+    /* The statistics refer to the removed overloads */
+    self->n_call_stats = 0;
+    Py_RETURN_NONE;
+}
+
+static void
+record_call(DispatcherObject *self, PyObject *cfunc, unsigned long long ticks)
+{
+    call_stats_t *stats = NULL;
+    Py_ssize_t i;
+    int bin = 0;
+
+    for (i = 0; i < self->n_call_stats; i++) {
+        if (self->call_stats[i].cfunc == cfunc) {
+            stats = &self->call_stats[i];
+            break;
+        }
+    }
+    if (stats == NULL) {
+        /* First call to this overload */
+        call_stats_t *newstats = PyMem_Realloc(
+            self->call_stats, (self->n_call_stats + 1) * sizeof(call_stats_t));
+        if (newstats == NULL)
+            return;
+        self->call_stats = newstats;
+        stats = &self->call_stats[self->n_call_stats++];
+        memset(stats, 0, sizeof(call_stats_t));
+        stats->cfunc = cfunc;
+    }
+    stats->calls++;
+    stats->total_ticks += ticks;
+    while (ticks >>= 1)
+        bin++;
+    stats->histogram[bin]++;
+}
+
+static PyObject *
+Dispatcher_call_stats(DispatcherObject *self, PyObject *args)
+{
+    PyObject *res = PyList_New(self->n_call_stats);
+    Py_ssize_t i;
+    int j;
+    if (res == NULL)
+        return NULL;
+    for (i = 0; i < self->n_call_stats; i++) {
+        call_stats_t *stats = &self->call_stats[i];
+        PyObject *item, *hist = PyTuple_New(CALL_STATS_NBINS);
+        if (hist == NULL)
+            goto error;
+        for (j = 0; j < CALL_STATS_NBINS; j++) {
+            PyObject *count = PyLong_FromUnsignedLongLong(stats->histogram[j]);
+            if (count == NULL) {
+                Py_DECREF(hist);
+                goto error;
+            }
+            PyTuple_SET_ITEM(hist, j, count);
+        }
+        item = Py_BuildValue("(OKKN)", stats->cfunc, stats->calls,
+                             stats->total_ticks, hist);
+        if (item == NULL)
+            goto error;
+        PyList_SET_ITEM(res, i, item);
+    }
+    return res;
+
+error:
+    Py_DECREF(res);
+    return NULL;
+}
+
+static PyObject *
+Dispatcher_reset_call_stats(DispatcherObject *self, PyObject *args)
+{
+    self->n_call_stats = 0;
     Py_RETURN_NONE;
 }
 
+static PyObject *
+Dispatcher_resolution_cache_stats(DispatcherObject *self, PyObject *args)
+{
+    size_t hits, misses, size;
+    dispatcher_cache_stats(self->dispatcher, &hits, &misses, &size);
+    return Py_BuildValue("(nnn)", (Py_ssize_t) hits, (Py_ssize_t) misses,
+                         (Py_ssize_t) size);
+}
+
 static
 PyObject*
 Dispatcher_Insert(DispatcherObject *self, PyObject *args)
@@ -227,6 +414,51 @@ Dispatcher_Insert(DispatcherObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
+/*
+ * Replace the entry point *old* of an overload with *new*, keeping the
+ * overload's place and call statistics.  As with Dispatcher_Insert, the
+ * references are borrowed: the caller keeps both entry points alive.
+ */
+static
+PyObject*
+Dispatcher_Replace(DispatcherObject *self, PyObject *args)
+{
+    PyObject *old, *cfunc;
+    Py_ssize_t i;
+    int objectmode = 0;
+    int interpmode = 0;
+
+    if (!PyArg_ParseTuple(args, "OO|ii", &old, &cfunc,
+                          &objectmode, &interpmode)) {
+        return NULL;
+    }
+
+    if (!interpmode && !PyObject_TypeCheck(cfunc, &PyCFunction_Type) ) {
+        PyErr_SetString(PyExc_TypeError, "must be builtin_function_or_method");
+        return NULL;
+    }
+
+    if (!interpmode) {
+        dispatcher_replace_defn(self->dispatcher, (void*) old, (void*) cfunc);
+    }
+    if (self->firstdef == old) {
+        self->firstdef = cfunc;
+    }
+    if (self->fallbackdef == old || (!self->fallbackdef && objectmode)) {
+        self->fallbackdef = cfunc;
+    }
+    if (self->interpdef == old || (!self->interpdef && interpmode)) {
+        self->interpdef = cfunc;
+    }
+    for (i = 0; i < self->n_call_stats; i++) {
+        if (self->call_stats[i].cfunc == old) {
+            self->call_stats[i].cfunc = cfunc;
+        }
+    }
+
+    Py_RETURN_NONE;
+}
+
 
 static
 void explain_issue(PyObject *dispatcher, PyObject *args, PyObject *kws,
@@ -383,34 +615,32 @@ compile_and_invoke(DispatcherObject *self, PyObject *args, PyObject *kws, PyObje
     return retval;
 }
 
-static int
-find_named_args(DispatcherObject *self, PyObject **pargs, PyObject **pkws)
+/*
+ * Fold the *nargs* positional arguments in *stack* and the *nkws* named
+ * arguments (*kwnames*, *kwvalues*) into a new tuple of all parameters,
+ * filling in default values and packing any stararg.
+ */
+static PyObject *
+fold_arguments(DispatcherObject *self, PyObject *const *stack,
+               Py_ssize_t nargs, PyObject *const *kwnames,
+               PyObject *const *kwvalues, Py_ssize_t nkws)
 {
-    PyObject *oldargs = *pargs, *newargs;
-    PyObject *kws = *pkws;
-    Py_ssize_t pos_args = PyTuple_GET_SIZE(oldargs);
-    Py_ssize_t named_args, total_args, i;
+    PyObject *newargs;
     Py_ssize_t func_args = PyTuple_GET_SIZE(self->argnames);
-    Py_ssize_t defaults = PyTuple_GET_SIZE(self->defargs);
-    /* Last parameter with a default value */
-    Py_ssize_t last_def = (self->has_stararg)
-                          ? func_args - 2
-                          : func_args - 1;
-    /* First parameter with a default value */
-    Py_ssize_t first_def = last_def - defaults + 1;
+    /* Parameters which can be passed positionally or by name */
+    Py_ssize_t named_params = (self->has_stararg) ? func_args - 1
+                                                  : func_args;
+    Py_ssize_t pos_args = Py_MIN(nargs, named_params);
+    Py_ssize_t total_args = nargs + nkws;
     /* Minimum number of required arguments */
-    Py_ssize_t minargs = first_def;
+    Py_ssize_t minargs = self->first_def;
+    Py_ssize_t i, j, unexpected = 0;
 
-    if (kws != NULL)
-        named_args = PyDict_Size(kws);
-    else
-        named_args = 0;
-    total_args = pos_args + named_args;
     if (!self->has_stararg && total_args > func_args) {
         PyErr_Format(PyExc_TypeError,
                      "too many arguments: expected %d, got %d",
                      (int) func_args, (int) total_args);
-        return -1;
+        return NULL;
     }
     else if (total_args < minargs) {
         if (minargs == func_args)
@@ -421,84 +651,143 @@ find_named_args(DispatcherObject *self, PyObject **pargs, PyObject **pkws)
             PyErr_Format(PyExc_TypeError,
                          "not enough arguments: expected at least %d, got %d",
                          (int) minargs, (int) total_args);
-        return -1;
+        return NULL;
     }
     newargs = PyTuple_New(func_args);
     if (!newargs)
-        return -1;
-    /* First pack the stararg */
+        return NULL;
+    /* First pack the stararg, and put it in last position */
     if (self->has_stararg) {
-        Py_ssize_t stararg_size = Py_MAX(0, pos_args - func_args + 1);
-        PyObject *stararg = PyTuple_New(stararg_size);
+        PyObject *stararg = PyTuple_New(nargs - pos_args);
         if (!stararg) {
             Py_DECREF(newargs);
-            return -1;
+            return NULL;
         }
-        for (i = 0; i < stararg_size; i++) {
-            PyObject *value = PyTuple_GET_ITEM(oldargs, func_args - 1 + i);
-            Py_INCREF(value);
-            PyTuple_SET_ITEM(stararg, i, value);
+        for (i = pos_args; i < nargs; i++) {
+            Py_INCREF(stack[i]);
+            PyTuple_SET_ITEM(stararg, i - pos_args, stack[i]);
         }
-        /* Put it in last position */
         PyTuple_SET_ITEM(newargs, func_args - 1, stararg);
-
     }
     for (i = 0; i < pos_args; i++) {
-        PyObject *value = PyTuple_GET_ITEM(oldargs, i);
-        if (self->has_stararg && i >= func_args - 1) {
-            /* Skip stararg */
-            break;
-        }
-        Py_INCREF(value);
-        PyTuple_SET_ITEM(newargs, i, value);
+        Py_INCREF(stack[i]);
+        PyTuple_SET_ITEM(newargs, i, stack[i]);
     }
 
-    /* Iterate over missing positional arguments, try to find them in
-       named arguments or default values. */
-    for (i = pos_args; i < func_args; i++) {
-        PyObject *name = PyTuple_GET_ITEM(self->argnames, i);
-        if (self->has_stararg && i >= func_args - 1) {
-            /* Skip stararg */
-            break;
+    /* Place named arguments in a single pass over them */
+    for (j = 0; j < nkws; j++) {
+        PyObject *name = kwnames[j];
+        Py_ssize_t pos = -1;
+        for (i = pos_args; i < named_params; i++) {
+            if (PyTuple_GET_ITEM(self->argnames, i) == name) {
+                pos = i;
+                break;
+            }
         }
-        if (kws != NULL) {
-            /* Named argument? */
-            PyObject *value = PyDict_GetItem(kws, name);
-            if (value != NULL) {
-                Py_INCREF(value);
-                PyTuple_SET_ITEM(newargs, i, value);
-                named_args--;
-                continue;
+        if (pos < 0) {
+            PyObject *posobj = PyDict_GetItemWithError(self->argpos, name);
+            if (posobj != NULL) {
+                pos = PyLong_AsSsize_t(posobj);
+            }
+            else if (PyErr_Occurred()) {
+                Py_DECREF(newargs);
+                return NULL;
             }
         }
-        if (i >= first_def && i <= last_def) {
-            /* Argument has a default value? */
-            PyObject *value = PyTuple_GET_ITEM(self->defargs, i - first_def);
+        if (pos < pos_args || pos >= named_params ||
+            PyTuple_GET_ITEM(newargs, pos) != NULL) {
+            /* Unknown, or already passed positionally */
+            unexpected++;
+            continue;
+        }
+        Py_INCREF(kwvalues[j]);
+        PyTuple_SET_ITEM(newargs, pos, kwvalues[j]);
+    }
+
+    /* Fill the remaining parameters with default values */
+    for (i = pos_args; i < named_params; i++) {
+        if (PyTuple_GET_ITEM(newargs, i) != NULL)
+            continue;
+        if (i >= self->first_def && i <= self->last_def) {
+            PyObject *value = PyTuple_GET_ITEM(self->defargs,
+                                               i - self->first_def);
             Py_INCREF(value);
             PyTuple_SET_ITEM(newargs, i, value);
-            continue;
         }
-        else if (i < func_args - 1 || !self->has_stararg) {
+        else {
             PyErr_Format(PyExc_TypeError,
                          "missing argument '%s'",
-                         PyString_AsString(name));
+                         PyString_AsString(PyTuple_GET_ITEM(self->argnames,
+                                                            i)));
             Py_DECREF(newargs);
-            return -1;
+            return NULL;
         }
     }
-    if (named_args) {
+    if (unexpected) {
         PyErr_Format(PyExc_TypeError,
                      "some keyword arguments unexpected");
         Py_DECREF(newargs);
-        return -1;
+        return NULL;
     }
+    return newargs;
+}
+
+static int
+find_named_args(DispatcherObject *self, PyObject **pargs, PyObject **pkws)
+{
+    PyObject *args = *pargs, *kws = *pkws, *newargs;
+    PyObject *prealloc[16];
+    PyObject **kwnames = prealloc;
+    Py_ssize_t nkws = 0, i = 0, pos = 0;
+    PyObject *key, *value;
+
+    if (kws != NULL && (nkws = PyDict_Size(kws)) > 0) {
+        /* Lay out the dict as vectorcall does: names, then values */
+        if (2 * nkws > (Py_ssize_t) (sizeof(prealloc) / sizeof(PyObject *))) {
+            kwnames = PyMem_Malloc(2 * nkws * sizeof(PyObject *));
+            if (kwnames == NULL) {
+                PyErr_NoMemory();
+                return -1;
+            }
+        }
+        while (PyDict_Next(kws, &pos, &key, &value)) {
+            kwnames[i] = key;
+            kwnames[nkws + i] = value;
+            i++;
+        }
+    }
+    newargs = fold_arguments(self, &PyTuple_GET_ITEM(args, 0),
+                             PyTuple_GET_SIZE(args), kwnames,
+                             kwnames + nkws, nkws);
+    if (kwnames != prealloc)
+        PyMem_Free(kwnames);
+    if (newargs == NULL)
+        return -1;
     *pargs = newargs;
     *pkws = NULL;
     return 0;
 }
 
+/* Get the caller's locals for the synthesized frame, if profiling */
+static int
+get_profiled_locals(PyObject **plocals)
+{
+    PyThreadState *ts = PyThreadState_Get();
+    *plocals = NULL;
+    if (ts->use_tracing && ts->c_profilefunc) {
+        *plocals = PyEval_GetLocals();
+        if (*plocals == NULL) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Select (or compile) the specialization for the tuple of folded
+   arguments *args* and call it */
 static PyObject*
-Dispatcher_call(DispatcherObject *self, PyObject *args, PyObject *kws)
+dispatch_folded_args(DispatcherObject *self, PyObject *args, PyObject *kws,
+                     PyObject *locals)
 {
     PyObject *tmptype, *retval = NULL;
     int *tys = NULL;
@@ -507,21 +796,6 @@ Dispatcher_call(DispatcherObject *self, PyObject *args, PyObject *kws)
     int prealloc[24];
     int matches;
     PyObject *cfunc;
-    PyThreadState *ts = PyThreadState_Get();
-    PyObject *locals = NULL;
-    if (ts->use_tracing && ts->c_profilefunc) {
-        locals = PyEval_GetLocals();
-        if (locals == NULL) {
-            goto CLEANUP;
-        }
-    }
-    if (self->fold_args) {
-        if (find_named_args(self, &args, &kws))
-            return NULL;
-    }
-    else
-        Py_INCREF(args);
-    /* Now we own a reference to args */
 
     argct = PySequence_Fast_GET_SIZE(args);
 
@@ -573,7 +847,13 @@ Dispatcher_call(DispatcherObject *self, PyObject *args, PyObject *kws)
 
     if (matches == 1) {
         /* Definition is found */
-        retval = call_cfunc(self, cfunc, args, kws, locals);
+        if (self->collect_stats) {
+            unsigned long long start = read_clock();
+            retval = call_cfunc(self, cfunc, args, kws, locals);
+            record_call(self, cfunc, read_clock() - start);
+        }
+        else
+            retval = call_cfunc(self, cfunc, args, kws, locals);
     } else if (matches == 0) {
         /* No matching definition */
         if (self->can_compile) {
@@ -598,20 +878,114 @@ Dispatcher_call(DispatcherObject *self, PyObject *args, PyObject *kws)
 CLEANUP:
     if (tys != prealloc)
         free(tys);
+
+    return retval;
+}
+
+static PyObject*
+Dispatcher_call(DispatcherObject *self, PyObject *args, PyObject *kws)
+{
+    PyObject *locals, *retval;
+    if (get_profiled_locals(&locals))
+        return NULL;
+    if (self->fold_args) {
+        if (find_named_args(self, &args, &kws))
+            return NULL;
+    }
+    else
+        Py_INCREF(args);
+    /* Now we own a reference to args */
+    retval = dispatch_folded_args(self, args, kws, locals);
     Py_DECREF(args);
+    return retval;
+}
+
+#if NUMBA_HAVE_VECTORCALL
+/*
+ * Vectorcall entry point.  The tuple of folded arguments (as expected by
+ * the compiled wrappers) is built directly from the caller's stack and
+ * keyword names, including any default values; there is no kwargs dict
+ * and no intermediate tuple.
+ */
+static PyObject *
+Dispatcher_vectorcall(PyObject *callable, PyObject *const *stack,
+                      size_t nargsf, PyObject *kwnames)
+{
+    DispatcherObject *self = (DispatcherObject *) callable;
+    Py_ssize_t nargs = PyVectorcall_NARGS(nargsf);
+    Py_ssize_t nkws = (kwnames != NULL) ? PyTuple_GET_SIZE(kwnames) : 0;
+    PyObject *args, *locals, *retval;
+    Py_ssize_t i;
+
+    if (self->fold_args) {
+        if (get_profiled_locals(&locals))
+            return NULL;
+        args = fold_arguments(self, stack, nargs,
+                              nkws ? &PyTuple_GET_ITEM(kwnames, 0) : NULL,
+                              stack + nargs, nkws);
+        if (args == NULL)
+            return NULL;
+        retval = dispatch_folded_args(self, args, NULL, locals);
+        Py_DECREF(args);
+        return retval;
+    }
 
+    args = PyTuple_New(nargs);
+    if (args == NULL)
+        return NULL;
+    for (i = 0; i < nargs; i++) {
+        Py_INCREF(stack[i]);
+        PyTuple_SET_ITEM(args, i, stack[i]);
+    }
+    if (nkws) {
+        /* Named arguments to a non-folding dispatcher (lifted code) */
+        PyObject *kws = PyDict_New();
+        if (kws == NULL) {
+            Py_DECREF(args);
+            return NULL;
+        }
+        for (i = 0; i < nkws; i++) {
+            if (PyDict_SetItem(kws, PyTuple_GET_ITEM(kwnames, i),
+                               stack[nargs + i])) {
+                Py_DECREF(args);
+                Py_DECREF(kws);
+                return NULL;
+            }
+        }
+        retval = Dispatcher_call(self, args, kws);
+        Py_DECREF(kws);
+    }
+    else {
+        if (get_profiled_locals(&locals)) {
+            Py_DECREF(args);
+            return NULL;
+        }
+        retval = dispatch_folded_args(self, args, NULL, locals);
+    }
+    Py_DECREF(args);
     return retval;
 }
+#endif
 
 static PyMethodDef Dispatcher_methods[] = {
     { "_clear", (PyCFunction)Dispatcher_clear, METH_NOARGS, NULL },
     { "_insert", (PyCFunction)Dispatcher_Insert, METH_VARARGS,
       "insert new definition"},
+    { "_replace", (PyCFunction)Dispatcher_Replace, METH_VARARGS,
+      "replace the entry point of a definition"},
+    { "_resolution_cache_stats",
+      (PyCFunction)Dispatcher_resolution_cache_stats, METH_NOARGS,
+      "return (hits, misses, size) of the signature resolution cache"},
+    { "_call_stats", (PyCFunction)Dispatcher_call_stats, METH_NOARGS,
+      "return a list of (cfunc, calls, total ticks, histogram)"},
+    { "_reset_call_stats", (PyCFunction)Dispatcher_reset_call_stats,
+      METH_NOARGS, NULL },
     { NULL },
 };
 
 static PyMemberDef Dispatcher_members[] = {
     {"_can_compile", T_BOOL, offsetof(DispatcherObject, can_compile), 0},
+    {"_collect_stats", T_BOOL, offsetof(DispatcherObject, collect_stats), 0},
     {NULL}  /* Sentinel */
 };
 
@@ -622,7 +996,11 @@ static PyTypeObject DispatcherType = {
     sizeof(DispatcherObject),                    /* tp_basicsize */
     0,                                           /* tp_itemsize */
     (destructor)Dispatcher_dealloc,              /* tp_dealloc */
+#if NUMBA_HAVE_VECTORCALL
+    offsetof(DispatcherObject, vectorcall),      /* tp_vectorcall_offset */
+#else
     0,                                           /* tp_print */
+#endif
     0,                                           /* tp_getattr */
     0,                                           /* tp_setattr */
     0,                                           /* tp_compare */
@@ -636,7 +1014,11 @@ static PyTypeObject DispatcherType = {
     0,                                           /* tp_getattro*/
     0,                                           /* tp_setattro*/
     0,                                           /* tp_as_buffer*/
-    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC, /* tp_flags*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC
+#if NUMBA_HAVE_VECTORCALL
+        | Py_TPFLAGS_HAVE_VECTORCALL
+#endif
+    ,                                            /* tp_flags*/
     "Dispatcher object",                         /* tp_doc */
     (traverseproc) Dispatcher_traverse,          /* tp_traverse */
     0,                                           /* tp_clear */
@@ -658,6 +1040,11 @@ static PyTypeObject DispatcherType = {
 };
 
 
+static PyObject *clock_ticks(PyObject *self, PyObject *args)
+{
+    return PyLong_FromUnsignedLongLong(read_clock());
+}
+
 static PyObject *compute_fingerprint(PyObject *self, PyObject *args)
 {
     PyObject *val;
@@ -666,10 +1053,77 @@ static PyObject *compute_fingerprint(PyObject *self, PyObject *args)
     return typeof_compute_fingerprint(val);
 }
 
+#if NUMBA_HAVE_VECTORCALL
+/*
+ * Heap subtypes don't inherit the vectorcall flag (see CPython's
+ * inherit_slots()); the Python dispatcher classes opt in explicitly,
+ * unless they override __call__.
+ */
+static PyObject *
+enable_vectorcall(PyObject *self, PyObject *args)
+{
+    PyTypeObject *tp;
+    if (!PyArg_ParseTuple(args, "O!:enable_vectorcall", &PyType_Type, &tp))
+        return NULL;
+    if (!PyType_IsSubtype(tp, &DispatcherType)) {
+        PyErr_SetString(PyExc_TypeError, "not a Dispatcher subclass");
+        return NULL;
+    }
+    if (tp->tp_call == (ternaryfunc) Dispatcher_call) {
+        tp->tp_flags |= Py_TPFLAGS_HAVE_VECTORCALL;
+        PyType_Modified(tp);
+    }
+    Py_RETURN_NONE;
+}
+#else
+static PyObject *
+enable_vectorcall(PyObject *self, PyObject *args)
+{
+    Py_RETURN_NONE;
+}
+#endif
+
+/*
+ * The entry point of an overload found in the cache but not loaded yet.
+ * It is bound to a Python callable which loads the overload and returns
+ * its actual entry point, to which the call is forwarded.
+ */
+static PyObject *
+lazy_overload_call(PyObject *loader, PyObject *args, PyObject *kws)
+{
+    PyObject *cfunc, *retval;
+    /* Loading replaces this entry point, which may release it */
+    Py_INCREF(loader);
+    cfunc = PyObject_CallObject(loader, NULL);
+    Py_DECREF(loader);
+    if (cfunc == NULL)
+        return NULL;
+    retval = PyObject_Call(cfunc, args, kws);
+    Py_DECREF(cfunc);
+    return retval;
+}
+
+static PyMethodDef lazy_overload_def = {
+    "lazy_overload", (PyCFunction) lazy_overload_call,
+    METH_VARARGS | METH_KEYWORDS, NULL
+};
+
+static PyObject *
+make_lazy_overload(PyObject *self, PyObject *args)
+{
+    PyObject *loader;
+    if (!PyArg_ParseTuple(args, "O:make_lazy_overload", &loader))
+        return NULL;
+    return PyCFunction_NewEx(&lazy_overload_def, loader, NULL);
+}
+
 static PyMethodDef ext_methods[] = {
 #define declmethod(func) { #func , ( PyCFunction )func , METH_VARARGS , NULL }
     declmethod(typeof_init),
     declmethod(compute_fingerprint),
+    declmethod(enable_vectorcall),
+    declmethod(clock_ticks),
+    declmethod(make_lazy_overload),
     { NULL },
 #undef declmethod
 };
@@ -1,6 +1,8 @@
 #ifndef NUMBA_DISPATCHER_H_
 #define NUMBA_DISPATCHER_H_
 
+#include <stddef.h>
+
 #ifdef __cplusplus
     extern "C" {
 #endif
@@ -19,6 +21,12 @@ dispatcher_del(dispatcher_t *obj);
 void
 dispatcher_add_defn(dispatcher_t *obj, int tys[], void* callable);
 
+/* Replace a definition's callable, returning the number of definitions
+   replaced */
+int
+dispatcher_replace_defn(dispatcher_t *obj, void *old_callable,
+                        void *new_callable);
+
 void*
 dispatcher_resolve(dispatcher_t *obj, int sig[], int *matches,
                    int allow_unsafe, int exact_match_required);
@@ -26,6 +34,11 @@ dispatcher_resolve(dispatcher_t *obj, int sig[], int *matches,
 int
 dispatcher_count(dispatcher_t *obj);
 
+/* Statistics of the exact-signature resolution cache */
+void
+dispatcher_cache_stats(dispatcher_t *obj, size_t *hits, size_t *misses,
+                       size_t *size);
+
 #ifdef __cplusplus
     }
 #endif
@@ -1,15 +1,40 @@
 #include "core/typeconv/typeconv.hpp"
 #include <cassert>
+#include <cstddef>
+#include <unordered_map>
 #include <vector>
 
 typedef std::vector<Type> TypeTable;
 typedef std::vector<void*> Functions;
 
+// Hash of a signature (plus the resolution flags) for the resolution cache
+struct SignatureHash {
+    std::size_t operator()(const TypeTable &key) const {
+        std::size_t h = 0;
+        for (TypeTable::const_iterator it = key.begin(); it != key.end();
+             ++it) {
+            h = h * 1000003 ^ static_cast<std::size_t>(*it);
+        }
+        return h;
+    }
+};
+
+typedef std::unordered_map<TypeTable, void*, SignatureHash> ResolutionCache;
+
+// Resolutions are only cached for up to this many distinct signatures;
+// past it, the cache is flushed rather than grown.
+static const std::size_t RESOLUTION_CACHE_MAX = 1024;
+
 struct _opaque_dispatcher {};
 
 class Dispatcher: public _opaque_dispatcher {
 public:
-    Dispatcher(TypeManager *tm, int argct): argct(argct), tm(tm) { }
+    Dispatcher(TypeManager *tm, int argct)
+        : argct(argct), tm(tm), generation(tm->getGeneration()),
+          hits(0), misses(0)
+    {
+        cacheKey.reserve(argct + 1);
+    }
 
     void addDefinition(Type args[], void *callable) {
         overloads.reserve(argct + overloads.size());
@@ -17,6 +42,8 @@ public:
             overloads.push_back(args[i]);
         }
         functions.push_back(callable);
+        // A new overload may be a better match for a cached signature
+        cache.clear();
     }
 
     void* resolve(Type sig[], int &matches, bool allow_unsafe,
@@ -28,6 +55,21 @@ public:
             // No overloads registered
             return NULL;
         }
+        if (generation != tm->getGeneration()) {
+            // Type conversion rules changed since the results were cached
+            cache.clear();
+            generation = tm->getGeneration();
+        }
+        cacheKey.assign(sig, sig + argct);
+        cacheKey.push_back(Type((allow_unsafe ? 1 : 0) |
+                                (exact_match_required ? 2 : 0)));
+        ResolutionCache::const_iterator it = cache.find(cacheKey);
+        if (it != cache.end()) {
+            ++hits;
+            matches = 1;
+            return it->second;
+        }
+        ++misses;
         if (argct == 0) {
             // Nullary function: trivial match on first overload
             matches = 1;
@@ -39,16 +81,43 @@ public:
                                          exact_match_required);
         }
         if (matches == 1) {
+            // Only unambiguous matches are cached; failed and ambiguous
+            // resolutions take the slow path again to report the error.
+            if (cache.size() >= RESOLUTION_CACHE_MAX) {
+                cache.clear();
+            }
+            cache[cacheKey] = functions[selected];
             return functions[selected];
         }
         return NULL;
     }
 
+    int replaceDefinition(void *old_callable, void *new_callable) {
+        int replaced = 0;
+        for (Functions::iterator it = functions.begin();
+             it != functions.end(); ++it) {
+            if (*it == old_callable) {
+                *it = new_callable;
+                ++replaced;
+            }
+        }
+        // Cached resolutions may refer to the old function
+        cache.clear();
+        return replaced;
+    }
+
     int count() const { return functions.size(); }
 
     void clear() {
         functions.clear();
         overloads.clear();
+        cache.clear();
+    }
+
+    void cacheStats(size_t &nhits, size_t &nmisses, size_t &size) const {
+        nhits = hits;
+        nmisses = misses;
+        size = cache.size();
     }
 
 private:
@@ -59,6 +128,14 @@ private:
     // A flattened array of argument types to all overloads
     // (invariant: sizeof(overloads) == argct * sizeof(functions))
     TypeTable overloads;
+    // Exact signature (plus resolution flags) -> selected function
+    ResolutionCache cache;
+    // Scratch key for cache lookups, to avoid allocating on every call
+    TypeTable cacheKey;
+    // TypeManager generation the cached resolutions are valid for
+    unsigned int generation;
+    size_t hits;
+    size_t misses;
 };
 
 
@@ -91,6 +168,13 @@ dispatcher_add_defn(dispatcher_t *obj, int tys[], void* callable) {
     disp->addDefinition(args, callable);
 }
 
+int
+dispatcher_replace_defn(dispatcher_t *obj, void *old_callable,
+                        void *new_callable) {
+    Dispatcher *disp = static_cast<Dispatcher*>(obj);
+    return disp->replaceDefinition(old_callable, new_callable);
+}
+
 void*
 dispatcher_resolve(dispatcher_t *obj, int sig[], int *count, int allow_unsafe,
                    int exact_match_required) {
@@ -106,3 +190,10 @@ dispatcher_count(dispatcher_t *obj) {
     Dispatcher *disp = static_cast<Dispatcher*>(obj);
     return disp->count();
 }
+
+void
+dispatcher_cache_stats(dispatcher_t *obj, size_t *hits, size_t *misses,
+                       size_t *size) {
+    Dispatcher *disp = static_cast<Dispatcher*>(obj);
+    disp->cacheStats(*hits, *misses, *size);
+}
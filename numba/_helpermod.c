@@ -131,6 +131,7 @@ build_c_helpers_dict(void)
     /* for dictionary support */
     declmethod(test_dict);
     declmethod(dict_new_minsize);
+    declmethod(dict_new_sized);
     declmethod(dict_set_method_table);
     declmethod(dict_free);
     declmethod(dict_length);
@@ -153,9 +154,12 @@ build_c_helpers_dict(void)
     declmethod(list_allocated);
     declmethod(list_is_mutable);
     declmethod(list_set_is_mutable);
+    declmethod(list_acquire_buffer);
+    declmethod(list_release_buffer);
     declmethod(list_setitem);
     declmethod(list_getitem);
     declmethod(list_append);
+    declmethod(list_append_items);
     declmethod(list_delitem);
     declmethod(list_delete_slice);
     declmethod(list_iter_sizeof);
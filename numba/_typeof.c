@@ -6,7 +6,6 @@
 
 #include "_numba_common.h"
 #include "_typeof.h"
-#include "_hashtable.h"
 
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
 #include <numpy/ndarrayobject.h>
@@ -28,6 +27,7 @@ static int tc_complex128;
 static int BASIC_TYPECODES[12];
 
 static int tc_intp;
+static int tc_unicode = -1;
 
 /* The type object for the numba .dispatcher.OmittedArg class
  * that wraps omitted arguments.
@@ -41,6 +41,7 @@ static PyObject *structured_dtypes;
 static PyObject *str_typeof_pyval = NULL;
 static PyObject *str_value = NULL;
 static PyObject *str_numba_type = NULL;
+static PyObject *str_numba_type_attr = NULL;
 
 
 /*
@@ -52,16 +53,29 @@ typedef struct {
     char *buf;
     size_t n;
     size_t allocated;
-    /* A preallocated buffer, sufficient to fit the fingerprint for most types */
-    char static_buf[40];
+    /* Hash of the bytes written so far (FNV-1a), updated as they are
+       written so that the buffer needn't be read again for lookup */
+    Py_uhash_t hash;
+    /* A preallocated buffer, sufficient to fit the fingerprint of most
+       types, including tuples of a few arrays */
+    char static_buf[256];
 } string_writer_t;
 
+#if SIZEOF_VOID_P >= 8
+#define FNV_OFFSET_BASIS ((Py_uhash_t) 0xcbf29ce484222325ULL)
+#define FNV_PRIME ((Py_uhash_t) 0x100000001b3ULL)
+#else
+#define FNV_OFFSET_BASIS ((Py_uhash_t) 0x811c9dc5UL)
+#define FNV_PRIME ((Py_uhash_t) 0x01000193UL)
+#endif
+
 static void
 string_writer_init(string_writer_t *w)
 {
     w->buf = w->static_buf;
     w->n = 0;
     w->allocated = sizeof(w->static_buf) / sizeof(unsigned char);
+    w->hash = FNV_OFFSET_BASIS;
 }
 
 static void
@@ -71,18 +85,15 @@ string_writer_clear(string_writer_t *w)
         free(w->buf);
 }
 
+/* Account for the *len* bytes just written at the end of the buffer */
 static void
-string_writer_move(string_writer_t *dest, const string_writer_t *src)
+string_writer_update_hash(string_writer_t *w, size_t len)
 {
-    dest->n = src->n;
-    dest->allocated = src->allocated;
-    if (src->buf == src->static_buf) {
-        dest->buf = dest->static_buf;
-        memcpy(dest->buf, src->buf, src->n);
-    }
-    else {
-        dest->buf = src->buf;
-    }
+    const unsigned char *p = (const unsigned char *) w->buf + w->n - len;
+    Py_uhash_t x = w->hash;
+    while (len-- > 0)
+        x = (x ^ *p++) * FNV_PRIME;
+    w->hash = x;
 }
 
 /* Ensure at least *bytes* can be appended to the string writer's buffer. */
@@ -116,6 +127,7 @@ string_writer_put_char(string_writer_t *w, unsigned char c)
     if (string_writer_ensure(w, 1))
         return -1;
     w->buf[w->n++] = c;
+    w->hash = (w->hash ^ c) * FNV_PRIME;
     return 0;
 }
 
@@ -129,6 +141,7 @@ string_writer_put_int32(string_writer_t *w, unsigned int v)
     w->buf[w->n + 2] = (v >> 16) & 0xff;
     w->buf[w->n + 3] = (v >> 24) & 0xff;
     w->n += 4;
+    string_writer_update_hash(w, 4);
     return 0;
 }
 
@@ -149,6 +162,7 @@ string_writer_put_intp(string_writer_t *w, npy_intp v)
         w->buf[w->n + 7] = (v >> 56) & 0xff;
     }
     w->n += N;
+    string_writer_update_hash(w, N);
     return 0;
 }
 
@@ -164,6 +178,7 @@ string_writer_put_string(string_writer_t *w, const char *s)
             return -1;
         memcpy(w->buf + w->n, s, N);
         w->n += N;
+        string_writer_update_hash(w, N);
         return 0;
     }
 }
@@ -179,6 +194,7 @@ enum opcode {
 
     OP_BYTEARRAY = 'a',
     OP_BYTES = 'b',
+    OP_UNICODE = 'u',
     OP_NONE = 'n',
     OP_LIST = '[',
     OP_SET = '{',
@@ -186,7 +202,9 @@ enum opcode {
     OP_BUFFER = 'B',
     OP_NP_SCALAR = 'S',
     OP_NP_ARRAY = 'A',
-    OP_NP_DTYPE = 'D'
+    OP_NP_DTYPE = 'D',
+    /* Followed by the typecode cached on the value */
+    OP_NUMBA_TYPE = 'T'
 };
 
 #define TRY(func, w, arg) \
@@ -203,6 +221,55 @@ fingerprint_unrecognized(PyObject *val)
     return -1;
 }
 
+/*
+ * Getting the typecode from a Type object.
+ */
+static int
+_typecode_from_type_object(PyObject *tyobj) {
+    int typecode;
+    PyObject *tmpcode = PyObject_GetAttrString(tyobj, "_code");
+    if (tmpcode == NULL) {
+        return -1;
+    }
+    typecode = PyLong_AsLong(tmpcode);
+    Py_DECREF(tmpcode);
+    return typecode;
+}
+
+/*
+ * Get the typecode of the Numba type cached on *val*, for classes which
+ * name the attribute holding it in "_numba_type_attr_" (typed containers,
+ * jitclass boxes).  The attribute is looked up in the instance dict, then
+ * on the class (where it mustn't be a descriptor), so that no Python code
+ * runs.  Returns -2 if there is no such type (e.g. an untyped container),
+ * -1 on error.
+ */
+static int
+typecode_from_cached_type(PyObject *val)
+{
+    PyTypeObject *tyobj = Py_TYPE(val);
+    PyObject *attr, *numba_type = NULL;
+    PyObject **dictptr;
+
+    attr = _PyType_Lookup(tyobj, str_numba_type_attr);
+    if (attr == NULL || !PyUnicode_CheckExact(attr))
+        return -2;
+    dictptr = _PyObject_GetDictPtr(val);
+    if (dictptr != NULL && *dictptr != NULL) {
+        numba_type = PyDict_GetItemWithError(*dictptr, attr);
+        if (numba_type == NULL && PyErr_Occurred())
+            return -1;
+    }
+    if (numba_type == NULL) {
+        numba_type = _PyType_Lookup(tyobj, attr);
+        if (numba_type != NULL && Py_TYPE(numba_type)->tp_descr_get != NULL)
+            return -2;
+    }
+    if (numba_type == NULL || numba_type == Py_None)
+        return -2;
+    return _typecode_from_type_object(numba_type);
+}
+
 static int
 compute_dtype_fingerprint(string_writer_t *w, PyArray_Descr *descr)
 {
@@ -266,6 +333,8 @@ compute_fingerprint(string_writer_t *w, PyObject *val)
         TRY(string_writer_put_char, w, OP_END_TUPLE);
         return 0;
     }
+    if (PyUnicode_CheckExact(val))
+        return string_writer_put_char(w, OP_UNICODE);
     if (PyBytes_Check(val))
         return string_writer_put_char(w, OP_BYTES);
     if (PyByteArray_Check(val))
@@ -336,6 +405,18 @@ compute_fingerprint(string_writer_t *w, PyObject *val)
         TRY(compute_fingerprint, w, item);
         return 0;
     }
+    {
+        /* Typed containers and jitclass instances: typecodes are never
+           reused, so the cached type's typecode denotes it. */
+        int typecode = typecode_from_cached_type(val);
+        if (typecode == -1)
+            return -1;
+        if (typecode >= 0) {
+            TRY(string_writer_put_char, w, OP_NUMBA_TYPE);
+            TRY(string_writer_put_int32, w, typecode);
+            return 0;
+        }
+    }
     if (PyObject_CheckBuffer(val)) {
         Py_buffer buf;
         int flags = PyBUF_ND | PyBUF_STRIDES | PyBUF_FORMAT;
@@ -403,21 +484,6 @@ error:
     return NULL;
 }
 
-/*
- * Getting the typecode from a Type object.
- */
-static int
-_typecode_from_type_object(PyObject *tyobj) {
-    int typecode;
-    PyObject *tmpcode = PyObject_GetAttrString(tyobj, "_code");
-    if (tmpcode == NULL) {
-        return -1;
-    }
-    typecode = PyLong_AsLong(tmpcode);
-    Py_DECREF(tmpcode);
-    return typecode;
-}
-
 /* When we want to cache the type's typecode for later lookup, we need to
    keep a reference to the returned type object so that it cannot be
    deleted. This is because of the following events occurring when first
@@ -489,37 +555,124 @@ int typecode_fallback_keep_ref(PyObject *dispatcher, PyObject *val) {
 }
 
 
-/* A cache mapping fingerprints (string_writer_t *) to typecodes (int). */
-static _Numba_hashtable_t *fingerprint_hashtable = NULL;
+/*
+ * A cache mapping fingerprints to typecodes: an open-addressing hash
+ * table (with linear probing) whose entries fit a cache line and hold
+ * short fingerprints inline.  Lookups never allocate; only fingerprints
+ * longer than FINGERPRINT_INLINE_SIZE get a heap copy, once, on insertion.
+ * Entries are never removed, as typecodes stay valid forever.
+ */
+
+#define FINGERPRINT_INLINE_SIZE 40
+#define FINGERPRINT_TABLE_INITIAL_SIZE 256
+
+typedef struct {
+    /* Fingerprint hash, 0 for unused entries */
+    Py_uhash_t hash;
+    int typecode;
+    unsigned int len;
+    /* Heap copy of the fingerprint, if too long to be stored inline */
+    char *long_key;
+    char key[FINGERPRINT_INLINE_SIZE];
+} fingerprint_entry_t;
+
+static fingerprint_entry_t *fingerprint_table = NULL;
+static size_t fingerprint_table_mask;
+static size_t fingerprint_table_used;
 
+/* The hash stored for a fingerprint (0 is reserved for unused entries) */
 static Py_uhash_t
-hash_writer(const void *key)
+fingerprint_hash(const string_writer_t *w)
 {
-    string_writer_t *writer = (string_writer_t *) key;
-    Py_uhash_t x = 0;
+    return w->hash ? w->hash : 1;
+}
 
-    /* The old FNV algorithm used by Python 2 */
-    if (writer->n > 0) {
-        unsigned char *p = (unsigned char *) writer->buf;
-        Py_ssize_t len = writer->n;
-        x ^= *p << 7;
-        while (--len >= 0)
-            x = (1000003*x) ^ *p++;
-        x ^= writer->n;
-        if (x == (Py_uhash_t) -1)
-            x = -2;
+static int
+fingerprint_table_init(void)
+{
+    fingerprint_table = calloc(FINGERPRINT_TABLE_INITIAL_SIZE,
+                               sizeof(fingerprint_entry_t));
+    if (fingerprint_table == NULL)
+        return -1;
+    fingerprint_table_mask = FINGERPRINT_TABLE_INITIAL_SIZE - 1;
+    fingerprint_table_used = 0;
+    return 0;
+}
+
+/* Return the entry for the fingerprint in *w*, or the unused entry
+   where it should be inserted. */
+static fingerprint_entry_t *
+fingerprint_table_find(fingerprint_entry_t *table, size_t mask,
+                       const string_writer_t *w, Py_uhash_t hash)
+{
+    size_t i = (size_t) hash & mask;
+    for (;;) {
+        fingerprint_entry_t *entry = &table[i];
+        if (entry->hash == 0)
+            return entry;
+        if (entry->hash == hash && entry->len == w->n &&
+            memcmp(entry->long_key ? entry->long_key : entry->key,
+                   w->buf, w->n) == 0)
+            return entry;
+        i = (i + 1) & mask;
     }
-    return x;
 }
 
 static int
-compare_writer(const void *key, const _Numba_hashtable_entry_t *entry)
+fingerprint_table_grow(void)
 {
-    string_writer_t *v = (string_writer_t *) key;
-    string_writer_t *w = (string_writer_t *) entry->key;
-    if (v->n != w->n)
-        return 0;
-    return memcmp(v->buf, w->buf, v->n) == 0;
+    size_t newmask = 2 * fingerprint_table_mask + 1;
+    size_t i;
+    fingerprint_entry_t *newtable = calloc(newmask + 1,
+                                           sizeof(fingerprint_entry_t));
+    if (newtable == NULL)
+        return -1;
+    for (i = 0; i <= fingerprint_table_mask; i++) {
+        fingerprint_entry_t *entry = &fingerprint_table[i];
+        size_t j;
+        if (entry->hash == 0)
+            continue;
+        j = (size_t) entry->hash & newmask;
+        while (newtable[j].hash != 0)
+            j = (j + 1) & newmask;
+        newtable[j] = *entry;
+    }
+    free(fingerprint_table);
+    fingerprint_table = newtable;
+    fingerprint_table_mask = newmask;
+    return 0;
+}
+
+static int
+fingerprint_table_insert(const string_writer_t *w, int typecode)
+{
+    Py_uhash_t hash = fingerprint_hash(w);
+    fingerprint_entry_t *entry;
+
+    /* Keep the load factor under 1/2 */
+    if (2 * (fingerprint_table_used + 1) > fingerprint_table_mask) {
+        if (fingerprint_table_grow())
+            return -1;
+    }
+    entry = fingerprint_table_find(fingerprint_table, fingerprint_table_mask,
+                                   w, hash);
+    if (entry->hash == 0) {
+        if (w->n > FINGERPRINT_INLINE_SIZE) {
+            entry->long_key = malloc(w->n);
+            if (entry->long_key == NULL)
+                return -1;
+            memcpy(entry->long_key, w->buf, w->n);
+        }
+        else {
+            entry->long_key = NULL;
+            memcpy(entry->key, w->buf, w->n);
+        }
+        entry->len = (unsigned int) w->n;
+        entry->hash = hash;
+        fingerprint_table_used++;
+    }
+    entry->typecode = typecode;
+    return 0;
 }
 
 /* Try to compute *val*'s typecode using its fingerprint and the
@@ -530,6 +683,7 @@ typecode_using_fingerprint(PyObject *dispatcher, PyObject *val)
 {
     int typecode;
     string_writer_t w;
+    fingerprint_entry_t *entry;
 
     string_writer_init(&w);
 
@@ -543,10 +697,12 @@ typecode_using_fingerprint(PyObject *dispatcher, PyObject *val)
         }
         return -1;
     }
-    if (_Numba_HASHTABLE_GET(fingerprint_hashtable, &w, typecode) > 0) {
+    entry = fingerprint_table_find(fingerprint_table, fingerprint_table_mask,
+                                   &w, fingerprint_hash(&w));
+    if (entry->hash != 0) {
         /* Cache hit */
         string_writer_clear(&w);
-        return typecode;
+        return entry->typecode;
     }
 
     /* Not found in cache: invoke pure Python typeof() and cache result.
@@ -554,23 +710,12 @@ typecode_using_fingerprint(PyObject *dispatcher, PyObject *val)
      * above in _typecode_fallback().
      */
     typecode = typecode_fallback_keep_ref(dispatcher, val);
-    if (typecode >= 0) {
-        string_writer_t *key = (string_writer_t *) malloc(sizeof(string_writer_t));
-        if (key == NULL) {
-            string_writer_clear(&w);
-            PyErr_NoMemory();
-            return -1;
-        }
-        /* Ownership of the string writer's buffer will be transferred
-         * to the hash table.
-         */
-        string_writer_move(key, &w);
-        if (_Numba_HASHTABLE_SET(fingerprint_hashtable, key, typecode)) {
-            string_writer_clear(&w);
-            PyErr_NoMemory();
-            return -1;
-        }
+    if (typecode >= 0 && fingerprint_table_insert(&w, typecode)) {
+        string_writer_clear(&w);
+        PyErr_NoMemory();
+        return -1;
     }
+    string_writer_clear(&w);
     return typecode;
 }
 
@@ -790,6 +935,8 @@ typeof_typecode(PyObject *dispatcher, PyObject *val)
         return tc_float64;
     else if (tyobj == &PyComplex_Type)
         return tc_complex128;
+    else if (tyobj == &PyUnicode_Type && tc_unicode != -1)
+        return tc_unicode;
     /* Array scalar handling */
     else if (PyArray_CheckScalar(val)) {
         return typecode_arrayscalar(dispatcher, val);
@@ -808,6 +955,12 @@ typeof_typecode(PyObject *dispatcher, PyObject *val)
             return typecode_ndarray(dispatcher, (PyArrayObject*)val);
         }
     }
+    else {
+        /* Typed containers and jitclass instances carry their type */
+        int typecode = typecode_from_cached_type(val);
+        if (typecode != -2)
+            return typecode;
+    }
 
     return typecode_using_fingerprint(dispatcher, val);
 }
@@ -882,6 +1035,10 @@ typeof_init(PyObject *self, PyObject *args)
 
     #undef UNWRAP_TYPE
 
+    /* Optional: the type of str arguments */
+    if ((tmpobj = PyDict_GetItemString(dict, "unicode_type")))
+        tc_unicode = PyLong_AsLong(tmpobj);
+
     typecache = PyDict_New();
     ndarray_typecache = PyDict_New();
     structured_dtypes = PyDict_New();
@@ -891,10 +1048,7 @@ typeof_init(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    fingerprint_hashtable = _Numba_hashtable_new(sizeof(int),
-                                              hash_writer,
-                                              compare_writer);
-    if (fingerprint_hashtable == NULL) {
+    if (fingerprint_table_init()) {
         PyErr_NoMemory();
         return NULL;
     }
@@ -905,7 +1059,9 @@ typeof_init(PyObject *self, PyObject *args)
     str_typeof_pyval = PyString_InternFromString("typeof_pyval");
     str_value = PyString_InternFromString("value");
     str_numba_type = PyString_InternFromString("_numba_type_");
-    if (!str_value || !str_typeof_pyval || !str_numba_type)
+    str_numba_type_attr = PyString_InternFromString("_numba_type_attr_");
+    if (!str_value || !str_typeof_pyval || !str_numba_type ||
+        !str_numba_type_attr)
         return NULL;
 
     Py_RETURN_NONE;
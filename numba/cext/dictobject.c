@@ -1011,6 +1011,19 @@ numba_dict_new_minsize(NB_Dict **out, Py_ssize_t key_size, Py_ssize_t val_size)
     return numba_dict_new(out, D_MINSIZE, key_size, val_size);
 }
 
+int
+numba_dict_new_sized(NB_Dict **out, Py_ssize_t n_keys, Py_ssize_t key_size, Py_ssize_t val_size)
+{
+    Py_ssize_t size, minsize;
+    /* Adapted from CPython's ESTIMATE_SIZE() */
+    if (n_keys > PY_SSIZE_T_MAX / 3) {
+        return ERR_NO_MEMORY;
+    }
+    minsize = (n_keys * 3 + 1) >> 1;
+    for (size = D_MINSIZE; size < minsize; size <<= 1);
+    return numba_dict_new(out, size, key_size, val_size);
+}
+
 void
 numba_dict_set_method_table(NB_Dict *d, type_based_methods_table *methods)
 {
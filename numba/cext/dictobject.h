@@ -105,6 +105,12 @@ See numba_dict_new().
 NUMBA_EXPORT_FUNC(int)
 numba_dict_new_minsize(NB_Dict **out, Py_ssize_t key_size, Py_ssize_t val_size);
 
+/* Allocates a new dict that can hold n_keys without resizing
+See numba_dict_new().
+*/
+NUMBA_EXPORT_FUNC(int)
+numba_dict_new_sized(NB_Dict **out, Py_ssize_t n_keys, Py_ssize_t key_size, Py_ssize_t val_size);
+
 /* Set the method table for type specific operations
 */
 NUMBA_EXPORT_FUNC(void)
@@ -77,6 +77,7 @@ typedef enum {
     LIST_ERR_MUTATED = -3,
     LIST_ERR_ITER_EXHAUSTED = -4,
     LIST_ERR_IMMUTABLE = -5,
+    LIST_ERR_EXPORTED = -6,
 } ListStatus;
 
 /* Copy an item from a list.
@@ -173,6 +174,7 @@ numba_list_new(NB_List **out, Py_ssize_t item_size, Py_ssize_t allocated){
     lp->item_size = item_size;
     lp->allocated = allocated;
     lp->is_mutable = 1;
+    lp->exports = 0;
     // set method table to zero */
     memset(&lp->methods, 0x00, sizeof(list_type_based_methods_table));
     // allocate memory to hold items, if requested
@@ -255,6 +257,29 @@ numba_list_set_is_mutable(NB_List *lp, int is_mutable){
     lp->is_mutable = is_mutable;
 }
 
+/* Export the items of a list, e.g. for an array view.
+ *
+ * lp: a list
+ *
+ * Returns the items pointer. The list cannot change size until the export
+ * is released with numba_list_release_buffer().
+ */
+char *
+numba_list_acquire_buffer(NB_List *lp){
+    lp->exports++;
+    return lp->items;
+}
+
+/* Release an export of the items of a list.
+ *
+ * lp: a list
+ */
+void
+numba_list_release_buffer(NB_List *lp){
+    assert(lp->exports > 0);
+    lp->exports--;
+}
+
 /* Set an item in a list.
  *
  * lp: a list
@@ -329,6 +354,33 @@ numba_list_append(NB_List *lp, const char *item) {
     return LIST_OK;
 }
 
+/* Append several items to the end of a list.
+ *
+ * lp: a list
+ * src: the items to append, stored contiguously
+ * count: the number of items to append
+ *
+ * The items are copied at once, after a single resize.
+ */
+int
+numba_list_append_items(NB_List *lp, const char *src, Py_ssize_t count) {
+    char *loc;
+    Py_ssize_t i, size = lp->size;
+    // resize by count, will check for mutability
+    int result = numba_list_resize(lp, size + count);
+    if(result < LIST_OK) {
+        return result;
+    }
+    loc = lp->items + lp->item_size * size;
+    memcpy(loc, src, lp->item_size * count);
+    if (lp->methods.item_incref) {
+        for (i = 0; i < count; i++) {
+            list_incref_item(lp, loc + lp->item_size * i);
+        }
+    }
+    return LIST_OK;
+}
+
 /* Resize a list.
  *
  * lp: a list
@@ -361,6 +413,10 @@ numba_list_resize(NB_List *lp, Py_ssize_t newsize) {
     if (!lp->is_mutable) {
         return LIST_ERR_IMMUTABLE;
     }
+    // check for exported items, which may be moved
+    if (lp->exports && newsize != lp->size) {
+        return LIST_ERR_EXPORTED;
+    }
     size_t new_allocated, num_allocated_bytes;
     /* Bypass realloc() when a previous overallocation is large enough
        to accommodate the newsize.  If the newsize falls lower than half
@@ -420,6 +476,10 @@ numba_list_delitem(NB_List *lp, Py_ssize_t index) {
     if (!valid_index(index, lp->size)) {
         return LIST_ERR_INDEX;
     }
+    // check for exported items, before they are moved
+    if (lp->exports) {
+        return LIST_ERR_EXPORTED;
+    }
     // obtain item and decref if needed
     loc = lp->items + lp->item_size * index;
     list_decref_item(lp, loc);
@@ -477,6 +537,10 @@ numba_list_delete_slice(NB_List *lp,
     if (slicelength <= 0){
         return LIST_OK;
     }
+    // check for exported items, before they are moved
+    if (lp->exports) {
+        return LIST_ERR_EXPORTED;
+    }
     new_length = lp->size - slicelength;
     // reverse step and indices
     if (step < 0) {
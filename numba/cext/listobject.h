@@ -47,6 +47,11 @@ typedef struct {
  * provided. Any attempt to mutate an immutable list will result in a status
  * of LIST_ERR_IMMUTABLE.
  *
+ * 'exports' counts the views of 'items' handed out by
+ * numba_list_acquire_buffer(). While it is non-zero, any attempt to change
+ * the size of the list (which may move 'items') will result in a status of
+ * LIST_ERR_EXPORTED.
+ *
  */
 typedef struct {
     /* size of the list in items  */
@@ -57,6 +62,8 @@ typedef struct {
     Py_ssize_t allocated;
     /* is the list mutable */
     int is_mutable;
+    /* number of exported views of the items */
+    Py_ssize_t exports;
     /* method table for type-dependent operations */
     list_type_based_methods_table methods;
     /* array/pointer for items. Interpretation is governed by item_size */
@@ -94,6 +101,12 @@ numba_list_is_mutable(NB_List *lp);
 NUMBA_EXPORT_FUNC(void)
 numba_list_set_is_mutable(NB_List *lp, int is_mutable);
 
+NUMBA_EXPORT_FUNC(char *)
+numba_list_acquire_buffer(NB_List *lp);
+
+NUMBA_EXPORT_FUNC(void)
+numba_list_release_buffer(NB_List *lp);
+
 NUMBA_EXPORT_FUNC(int)
 numba_list_setitem(NB_List *lp, Py_ssize_t index, const char *item);
 
@@ -104,6 +117,9 @@ NUMBA_EXPORT_FUNC(int)
 numba_list_append(NB_List *lp, const char *item);
 
 // FIXME: should this be public?
+NUMBA_EXPORT_FUNC(int)
+numba_list_append_items(NB_List *lp, const char *src, Py_ssize_t count);
+
 NUMBA_EXPORT_FUNC(int)
 numba_list_resize(NB_List *lp, Py_ssize_t newsize);
 
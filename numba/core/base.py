@@ -2,6 +2,7 @@ from collections import namedtuple, defaultdict
 import copy
 import os
 import sys
+import threading
 from itertools import permutations, takewhile
 from contextlib import contextmanager
 
@@ -208,6 +209,7 @@ class BaseContext(object):
 
     # NRT
     enable_nrt = False
+    enable_nrt_arena = False
 
     # Auto parallelization
     auto_parallel = False
@@ -249,7 +251,8 @@ class BaseContext(object):
         self.special_ops = {}
         self.cached_internal_func = {}
         self._pid = None
-        self._codelib_stack = []
+        # Per thread, as compilations on different threads may overlap
+        self._codelib_local = threading.local()
 
         self._boundscheck = False
 
@@ -272,7 +275,7 @@ class BaseContext(object):
         from numba.cpython import (slicing, tupleobj, enumimpl, hashing, heapq,
                                    iterators, numbers, rangeobj)
         from numba.core import optional
-        from numba.misc import gdb_hook, literal
+        from numba.misc import gdb_hook, literal, arrowimpl
         from numba.np import linalg, polynomial, arraymath
 
         try:
@@ -1123,6 +1126,14 @@ class BaseContext(object):
         """
         return lc.Module(name)
 
+    @property
+    def _codelib_stack(self):
+        try:
+            return self._codelib_local.stack
+        except AttributeError:
+            self._codelib_local.stack = []
+            return self._codelib_local.stack
+
     @property
     def active_code_library(self):
         """Get the active code library
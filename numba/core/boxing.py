@@ -445,16 +445,19 @@ def unbox_array(typ, obj, c):
     aryptr = nativeary._getpointer()
 
     ptr = c.builder.bitcast(aryptr, c.pyapi.voidptr)
-    if c.context.enable_nrt:
-        errcode = c.pyapi.nrt_adapt_ndarray_from_python(obj, ptr)
-    else:
-        errcode = c.pyapi.numba_array_adaptor(obj, ptr)
-
     # TODO: here we have minimal typechecking by the itemsize.
     #       need to do better
     try:
         expected_itemsize = numpy_support.as_dtype(typ.dtype).itemsize
     except NotImplementedError:
+        expected_itemsize = None
+    if c.context.enable_nrt:
+        errcode = c.pyapi.nrt_adapt_array_from_python(
+            obj, typ.ndim, expected_itemsize or 0, ptr)
+    else:
+        errcode = c.pyapi.numba_array_adaptor(obj, ptr)
+
+    if expected_itemsize is None:
         # Don't check types that can't be `as_dtype()`-ed
         itemsize_mismatch = cgutils.false_bit
     else:
@@ -478,6 +481,47 @@ def unbox_array(typ, obj, c):
     return NativeValue(c.builder.load(aryptr), is_error=failed)
 
 
+@box(types.DLPackCapsule)
+def box_dlpack_capsule(typ, val, c):
+    """
+    Export the array held by *val* as a DLPack capsule.
+    """
+    ary = c.builder.extract_value(val, 0)
+    # Steals NRT ref
+    return c.pyapi.nrt_adapt_ndarray_to_dlpack(typ.array_type, ary)
+
+
+@unbox(types.ArrowArray)
+def unbox_arrow_array(typ, obj, c):
+    """
+    Adopt the array exported by *obj* through the Arrow C Data Interface.
+    """
+    arrow = c.context.make_helper(c.builder, typ)
+    ptr = c.builder.bitcast(arrow._getpointer(), c.pyapi.voidptr)
+    errcode = c.pyapi.nrt_adapt_arrow_from_python(obj, typ.format, ptr)
+    failed = cgutils.is_not_null(c.builder, errcode)
+    return NativeValue(arrow._getvalue(), is_error=failed)
+
+
+@box(types.ArrowArray)
+def box_arrow_array(typ, val, c):
+    """
+    Return the object the Arrow array was exported from.
+    """
+    arrow = c.context.make_helper(c.builder, typ, value=val)
+    parent = arrow.parent
+    with c.builder.if_else(cgutils.is_not_null(c.builder, parent)) \
+            as (has_parent, no_parent):
+        with has_parent:
+            c.pyapi.incref(parent)
+        with no_parent:
+            c.pyapi.err_set_string("PyExc_TypeError",
+                                   "cannot box Arrow array without a "
+                                   "parent object")
+    c.context.nrt.decref(c.builder, typ, val)
+    return parent
+
+
 @box(types.Tuple)
 @box(types.UniTuple)
 def box_tuple(typ, val, c):
@@ -4,17 +4,30 @@ Caching mechanism for compiled functions.
 
 
 from abc import ABCMeta, abstractmethod, abstractproperty
+from collections import namedtuple
 import contextlib
+import dis
 import errno
 import hashlib
 import inspect
+import io
 import itertools
+import mmap
 import os
 import pickle
+import struct
 import sys
+import sysconfig
 import tempfile
+import threading
+import time
+import types as pytypes
 import warnings
+import zlib
 
+import numpy as np
+
+from numba import _dispatcher
 from numba.misc.appdirs import AppDirs
 from numba.core.utils import add_metaclass, file_replace
 
@@ -23,6 +36,7 @@ from numba.core.errors import NumbaWarning
 from numba.core.base import BaseContext
 from numba.core.codegen import CodeLibrary
 from numba.core.compiler import CompileResult
+from numba.core.compiler_lock import global_compiler_lock
 from numba.core import config, compiler
 from numba.core.serialize import dumps
 
@@ -64,6 +78,18 @@ class _Cache(object):
         in the cache.
         """
 
+    def load_overload_lazily(self, sig, target_context):
+        """
+        Return a (loader, info) tuple for the given signature, or None if
+        not found in the cache.  The loader returns the overload as
+        load_overload() would; implementations may defer loading it to the
+        call.  *info* is the dict of index information saved with the
+        overload (see _CacheImpl.index_info()), possibly empty.
+        """
+        data = self.load_overload(sig, target_context)
+        if data is not None:
+            return (lambda: data), {}
+
     @abstractmethod
     def save_overload(self, sig, data):
         """
@@ -110,6 +136,233 @@ class NullCache(_Cache):
         pass
 
 
+_compressed_magic = b'NBZ1'
+
+
+def _compress_data(data):
+    """
+    Compress the serialized *data* of a cache entry, if enabled by
+    NUMBA_CACHE_COMPRESSION.
+    """
+    level = config.CACHE_COMPRESSION
+    if level:
+        return _compressed_magic + zlib.compress(data, level)
+    return data
+
+
+def _decompress_data(data):
+    """
+    Return the serialized data of a cache entry from the stored *data*,
+    compressed or not (pickles never start with the magic).
+    """
+    if data[:len(_compressed_magic)] == _compressed_magic:
+        return zlib.decompress(data[len(_compressed_magic):])
+    return data
+
+
+def _file_access_time(st):
+    """
+    Return when the cache data file with stat result *st* was last used:
+    saved, or loaded (see IndexDataCacheFile._record_access()).
+    """
+    return max(st.st_atime, st.st_mtime)
+
+
+_library_dirs = None
+
+
+def _is_library_code(code):
+    """
+    Whether *code* comes from the standard library, an installed package
+    or Numba itself, rather than from the user's code.
+    """
+    global _library_dirs
+    if _library_dirs is None:
+        paths = sysconfig.get_paths()
+        dirs = [paths.get(name) for name in
+                ('stdlib', 'platstdlib', 'purelib', 'platlib')]
+        dirs.append(os.path.dirname(numba.__file__))
+        _library_dirs = tuple(os.path.join(os.path.abspath(d), '')
+                              for d in dirs if d)
+    if code.co_filename.startswith('<frozen'):
+        return True
+    return os.path.abspath(code.co_filename).startswith(_library_dirs)
+
+
+# Content hashes of source files, by path: (mtime, size, hash)
+_source_hashes = {}
+
+
+def _source_file_hash(path):
+    """
+    Return a hash of the contents of the source file at *path*, only read
+    again once its modification time or size changes.
+    """
+    st = os.stat(path)
+    cached = _source_hashes.get(path)
+    if cached is not None and cached[:2] == (st.st_mtime, st.st_size):
+        return cached[2]
+    with open(path, 'rb') as f:
+        digest = hashlib.sha256(f.read()).hexdigest()
+    _source_hashes[path] = st.st_mtime, st.st_size, digest
+    return digest
+
+
+class _FunctionHasher(object):
+    """
+    Computes the hashes which key a function's entries in the cache index:
+    one of its own code, and one of its dependencies, i.e. the globals,
+    closure variables and default values it captures, recursing into
+    the jitted functions and user-defined Python functions among them.
+    """
+
+    def __init__(self):
+        # Dependency hashes of the functions seen so far
+        self._hashes = {}
+        # (array, hash) pairs of the arrays seen so far, by id
+        self._array_hashes = {}
+        # Ids of the containers being hashed, against cycles
+        self._in_progress = set()
+
+    def hash_function(self, func):
+        """
+        Return the (code hash, dependencies hash) pair of *func*.
+        """
+        code = func.__code__
+        h = hashlib.sha256()
+        # The globals read by the function, and all the names it uses
+        # (e.g. the attributes of modules)
+        globals_read = set()
+        names = set()
+        self._update_code(h, code, globals_read, names)
+        code_hash = h.hexdigest()
+
+        deps_hash = self._hashes.get(func)
+        if deps_hash is None:
+            # Placeholder for recursive functions
+            self._hashes[func] = ''
+            h = hashlib.sha256(code_hash.encode())
+            globs = func.__globals__
+            for name in sorted(globals_read):
+                if name in globs:
+                    h.update(name.encode())
+                    h.update(self._hash_value(globs[name], names))
+            for cell in func.__closure__ or ():
+                try:
+                    value = cell.cell_contents
+                except ValueError:
+                    # Empty cell
+                    continue
+                h.update(self._hash_value(value, names))
+            h.update(self._hash_value(func.__defaults__, names))
+            h.update(self._hash_value(func.__kwdefaults__, names))
+            deps_hash = self._hashes[func] = h.hexdigest()
+        return code_hash, deps_hash
+
+    def _update_code(self, h, code, globals_read, names):
+        h.update(code.co_code)
+        attrs = (code.co_argcount, getattr(code, 'co_posonlyargcount', 0),
+                 code.co_kwonlyargcount, code.co_flags, code.co_names,
+                 code.co_varnames, code.co_freevars, code.co_cellvars)
+        h.update(repr(attrs).encode())
+        names.update(code.co_names)
+        globals_read.update(inst.argval for inst in dis.get_instructions(code)
+                            if inst.opname == 'LOAD_GLOBAL')
+        for const in code.co_consts:
+            if isinstance(const, pytypes.CodeType):
+                # Nested functions, lambdas and comprehensions
+                self._update_code(h, const, globals_read, names)
+            else:
+                h.update(self._const_repr(const).encode())
+
+    def _const_repr(self, const):
+        # Independent of the string hashing seed
+        if isinstance(const, frozenset):
+            return 'frozenset(%s)' % sorted(map(self._const_repr, const))
+        elif isinstance(const, tuple):
+            return '(%s)' % ','.join(map(self._const_repr, const))
+        return '%s:%r' % (type(const).__name__, const)
+
+    def _hash_value(self, value, names):
+        if isinstance(value, _dispatcher.Dispatcher):
+            # A jitted callee: its options matter as well as its code
+            options = sorted(getattr(value, 'targetoptions', {}).items())
+            deps = self.hash_function(value.py_func)
+            return repr((options, deps)).encode()
+        elif isinstance(value, pytypes.FunctionType):
+            if _is_library_code(value.__code__):
+                return ('%s.%s' % (value.__module__,
+                                   value.__qualname__)).encode()
+            return repr(self.hash_function(value)).encode()
+        elif isinstance(value, pytypes.ModuleType):
+            # Only the jitted functions accessed as attributes of the module
+            # are followed, e.g. ``mod.func(x)``
+            parts = [value.__name__]
+            for name in sorted(names):
+                attr = getattr(value, name, None)
+                if isinstance(attr, _dispatcher.Dispatcher):
+                    parts.append((name, self._hash_value(attr, names)))
+            return repr(parts).encode()
+        elif isinstance(value, (tuple, list, dict, set, frozenset)):
+            return self._hash_container(value, names)
+        elif isinstance(value, np.ndarray):
+            return self._hash_array(value)
+        try:
+            data = dumps(value)
+        except Exception:
+            # Unpicklable (such values are generally uncachable anyway)
+            data = ('%s.%s' % (type(value).__module__,
+                               type(value).__qualname__)).encode()
+        return hashlib.sha256(data).digest()
+
+    def _hash_container(self, value, names):
+        # Hash the items rather than pickling the container, as they may be
+        # jitted functions (whose pickles hold a per-process uuid), or
+        # strings (whose order in sets depends on the hashing seed)
+        if id(value) in self._in_progress:
+            return b'<cycle>'
+        self._in_progress.add(id(value))
+        try:
+            if isinstance(value, dict):
+                items = [self._hash_value(k, names) +
+                         self._hash_value(v, names)
+                         for k, v in value.items()]
+            else:
+                items = [self._hash_value(v, names) for v in value]
+            if isinstance(value, (set, frozenset)):
+                items.sort()
+        finally:
+            self._in_progress.discard(id(value))
+        h = hashlib.sha256(type(value).__name__.encode())
+        for item in items:
+            h.update(item)
+        return h.digest()
+
+    def _hash_array(self, value):
+        # Hash the data in place rather than pickling a copy of it, and
+        # only once per array
+        try:
+            return self._array_hashes[id(value)][1]
+        except KeyError:
+            pass
+        h = hashlib.sha256(repr((value.dtype.str, value.shape)).encode())
+        if value.dtype.hasobject:
+            h.update(dumps(value))
+        else:
+            h.update(value.ravel().view(np.uint8))
+        digest = h.digest()
+        self._array_hashes[id(value)] = value, digest
+        return digest
+
+
+def get_user_cache_dir():
+    """
+    Return the user-wide cache directory.
+    """
+    appdirs = AppDirs(appname="numba", appauthor=False)
+    return appdirs.user_cache_dir
+
+
 @add_metaclass(ABCMeta)
 class _CacheLocator(object):
     """
@@ -132,10 +385,20 @@ class _CacheLocator(object):
         Return the directory the function is cached in.
         """
 
+    def get_cache_root(self):
+        """
+        Return the directory whose total size is bounded by
+        NUMBA_CACHE_MAX_SIZE: the cache directory itself, or the top of
+        the tree of cache directories it belongs to.
+        """
+        return self.get_cache_path()
+
     @abstractmethod
     def get_source_stamp(self):
         """
-        Get a timestamp representing the source code's freshness.
+        Get a timestamp representing the source code's freshness, besides
+        the hashes of the function's code and dependencies which are part
+        of the index key.
         Can return any picklable Python object.
         """
 
@@ -181,11 +444,13 @@ class _SourceFileBackedLocatorMixin(object):
     def get_source_stamp(self):
         if getattr(sys, 'frozen', False):
             st = os.stat(sys.executable)
-        else:
-            st = os.stat(self._py_file)
-        # We use both timestamp and size as some filesystems only have second
-        # granularity.
-        return st.st_mtime, st.st_size
+            # We use both timestamp and size as some filesystems only have
+            # second granularity.
+            return st.st_mtime, st.st_size
+        # The index key tracks changes to the function and its dependencies,
+        # but not to the @overload, @intrinsic or jitclass definitions in
+        # the same file which it may use
+        return _source_file_hash(self._py_file)
 
     def get_disambiguator(self):
         return str(self._lineno)
@@ -213,11 +478,15 @@ class _UserProvidedCacheLocator(_SourceFileBackedLocatorMixin, _CacheLocator):
         self._py_file = py_file
         self._lineno = py_func.__code__.co_firstlineno
         cache_subpath = self.get_suitable_cache_subpath(py_file)
-        self._cache_path = os.path.join(config.CACHE_DIR, cache_subpath)
+        self._cache_root = config.CACHE_DIR
+        self._cache_path = os.path.join(self._cache_root, cache_subpath)
 
     def get_cache_path(self):
         return self._cache_path
 
+    def get_cache_root(self):
+        return self._cache_root
+
     @classmethod
     def from_function(cls, py_func, py_file):
         if not config.CACHE_DIR:
@@ -250,14 +519,16 @@ class _UserWideCacheLocator(_SourceFileBackedLocatorMixin, _CacheLocator):
     def __init__(self, py_func, py_file):
         self._py_file = py_file
         self._lineno = py_func.__code__.co_firstlineno
-        appdirs = AppDirs(appname="numba", appauthor=False)
-        cache_dir = appdirs.user_cache_dir
+        self._cache_root = get_user_cache_dir()
         cache_subpath = self.get_suitable_cache_subpath(py_file)
-        self._cache_path = os.path.join(cache_dir, cache_subpath)
+        self._cache_path = os.path.join(self._cache_root, cache_subpath)
 
     def get_cache_path(self):
         return self._cache_path
 
+    def get_cache_root(self):
+        return self._cache_root
+
     @classmethod
     def from_function(cls, py_func, py_file):
         if not (os.path.exists(py_file) or getattr(sys, 'frozen', False)):
@@ -394,6 +665,10 @@ class _CacheImpl(object):
         "Returns True if the given data is cachable; otherwise, returns False."
         pass
 
+    def index_info(self, data):
+        "Returns a dict of information about the data to keep in the index"
+        return {}
+
 
 class CompileResultCacheImpl(_CacheImpl):
     """
@@ -412,6 +687,15 @@ class CompileResultCacheImpl(_CacheImpl):
         """
         return compiler.CompileResult._rebuild(target_context, *payload)
 
+    def index_info(self, cres):
+        """
+        Returns what the dispatcher needs to know about an overload before
+        loading it.
+        """
+        return {'signature': cres.signature,
+                'objectmode': cres.objectmode,
+                'interpmode': cres.interpmode}
+
     def check_cachable(self, cres):
         """
         Check cachability of the given compile result.
@@ -473,19 +757,31 @@ class IndexDataCacheFile(object):
         self._data_name_pattern = '%s.{number:d}.nbc' % (filename_base,)
         self._source_stamp = source_stamp
         self._version = numba.__version__
+        # The file identity and contents of the index last read
+        self._index_cache = None
+
+    # Granularity of the access times recorded on the data files, so as
+    # not to update them on every load
+    _access_time_resolution = 3600
 
     def flush(self):
         self._save_index({})
 
-    def save(self, key, data):
+    def save(self, key, data, superseded=None, info=None):
         """
-        Save a new cache entry with *key* and *data*.
+        Save a new cache entry with *key* and *data*, and the *info* dict
+        in the index.  The existing entries whose key satisfies the
+        *superseded* predicate are removed, and their data files reused.
+        Return the number of bytes written.
         """
-        overloads = self._load_index()
-        try:
-            # If key already exists, we will overwrite the file
-            data_name = overloads[key]
-        except KeyError:
+        overloads, infos = self._load_index_entries()
+        if superseded is not None:
+            for k in [k for k in overloads if k != key and superseded(k)]:
+                del overloads[k]
+                infos.pop(k, None)
+        # If key already exists, we will overwrite the file
+        data_name = overloads.get(key)
+        if data_name is None:
             # Find an available name for the data file
             existing = set(overloads.values())
             for i in itertools.count(1):
@@ -493,52 +789,113 @@ class IndexDataCacheFile(object):
                 if data_name not in existing:
                     break
             overloads[key] = data_name
-            self._save_index(overloads)
-        self._save_data(data_name, data)
+        infos[key] = info or {}
+        self._save_index(overloads, infos)
+        return self._save_data(data_name, data)
+
+    def lookup(self, key):
+        """
+        Return the info dict of the cache entry with *key*, or None if there
+        is none, reading only the index.
+        """
+        overloads, infos = self._load_index_entries()
+        if key in overloads:
+            return infos.get(key, {})
 
     def load(self, key):
         """
         Load a cache entry with *key*.
         """
-        overloads = self._load_index()
+        overloads, infos = self._load_index_entries()
         data_name = overloads.get(key)
         if data_name is None:
             return
         try:
-            return self._load_data(data_name)
+            data = self._load_data(data_name)
         except EnvironmentError:
             # File could have been removed while the index still refers it.
             return
+        self._record_access(data_name)
+        return data
 
-    def _load_index(self):
+    def _record_access(self, name):
         """
-        Load the cache index and return it as a dictionary (possibly
-        empty if cache is empty or obsolete).
+        Record that the data file *name* was loaded, as its access time.
+        The index isn't rewritten, so that loading never races with the
+        saves of other processes.
+        """
+        path = self._data_path(name)
+        try:
+            st = os.stat(path)
+            now = time.time()
+            if now - _file_access_time(st) > self._access_time_resolution:
+                os.utime(path, (now, st.st_mtime))
+        except EnvironmentError:
+            # Removed meanwhile, or read-only cache directory
+            pass
+
+    def _read_index(self):
+        """
+        Read the cache index and return its source stamp, overloads and
+        infos, or None if it doesn't exist or is from another version.
+        The index isn't read again as long as the file is unchanged.
         """
         try:
             with open(self._index_path, "rb") as f:
-                version = pickle.load(f)
-                data = f.read()
+                st = os.fstat(f.fileno())
+                file_id = (st.st_ino, st.st_size, st.st_mtime_ns)
+                cached = self._index_cache
+                if cached is not None and cached[0] == file_id:
+                    index = cached[1]
+                else:
+                    index = self._parse_index(f)
+                    self._index_cache = file_id, index
         except EnvironmentError as e:
             # Index doesn't exist yet?
             if e.errno in (errno.ENOENT,):
-                return {}
+                return None
             raise
+        if index is None:
+            return None
+        stamp, overloads, infos = index
+        # The caller may modify the dicts
+        return stamp, dict(overloads), dict(infos)
+
+    def _parse_index(self, f):
+        version = pickle.load(f)
         if version != self._version:
             # This is another version.  Avoid trying to unpickling the
             # rest of the stream, as that may fail.
-            return {}
-        stamp, overloads = pickle.loads(data)
+            return None
+        index = pickle.loads(f.read())
         _cache_log("[cache] index loaded from %r", self._index_path)
+        # Indexes written before infos were recorded lack them
+        stamp, overloads = index[:2]
+        infos = index[-1] if len(index) > 2 else {}
+        return stamp, overloads, infos
+
+    def _load_index_entries(self):
+        index = self._read_index()
+        if index is None:
+            return {}, {}
+        stamp, overloads, infos = index
         if stamp != self._source_stamp:
             # Cache is not fresh.  Stale data files will be eventually
             # overwritten, since they are numbered in incrementing order.
-            return {}
-        else:
-            return overloads
+            return {}, {}
+        return overloads, infos
+
+    def _load_index(self):
+        """
+        Load the cache index and return it as a dictionary (possibly
+        empty if cache is empty or obsolete).
+        """
+        return self._load_index_entries()[0]
 
-    def _save_index(self, overloads):
-        data = self._source_stamp, overloads
+    def _save_index(self, overloads, infos=None):
+        if infos is None:
+            infos = {}
+        data = self._source_stamp, overloads, infos
         data = self._dump(data)
         with self._open_for_write(self._index_path) as f:
             pickle.dump(self._version, f, protocol=-1)
@@ -549,16 +906,17 @@ class IndexDataCacheFile(object):
         path = self._data_path(name)
         with open(path, "rb") as f:
             data = f.read()
-        tup = pickle.loads(data)
+        tup = pickle.loads(_decompress_data(data))
         _cache_log("[cache] data loaded from %r", path)
         return tup
 
     def _save_data(self, name, data):
-        data = self._dump(data)
+        data = _compress_data(self._dump(data))
         path = self._data_path(name)
         with self._open_for_write(path) as f:
             f.write(data)
         _cache_log("[cache] data saved to %r", path)
+        return len(data)
 
     def _data_name(self, number):
         return self._data_name_pattern.format(number=number)
@@ -589,6 +947,625 @@ class IndexDataCacheFile(object):
             raise
 
 
+@contextlib.contextmanager
+def _locked_file(f):
+    """
+    Hold an exclusive lock on the open file *f*, across processes.
+    """
+    if os.name == 'nt':
+        import msvcrt
+        f.seek(0)
+        msvcrt.locking(f.fileno(), msvcrt.LK_LOCK, 1)
+        try:
+            yield
+        finally:
+            f.seek(0)
+            msvcrt.locking(f.fileno(), msvcrt.LK_UNLCK, 1)
+    else:
+        import fcntl
+        fcntl.flock(f.fileno(), fcntl.LOCK_EX)
+        try:
+            yield
+        finally:
+            fcntl.flock(f.fileno(), fcntl.LOCK_UN)
+
+
+class _PackedStore(object):
+    """
+    An append-only container file holding the cache entries of all the
+    functions cached in a directory.
+
+    The file starts with a magic string, followed by records made of a
+    header (tag, key length, data length), the key and the pickled data.
+    The key is the function's filename base and the pickled entry key,
+    separated by a NUL byte.  Entries are indexed by the raw key bytes, so
+    that indexing the file unpickles nothing.  A later record for the same key
+    supersedes the earlier ones; a record with an empty data part deletes
+    the entry, or all the entries of the function if its pickled key is
+    empty too.  The file is memory-mapped and the records are indexed as
+    the file grows.  Writers append under an exclusive file lock; readers
+    need none since records never change once written.  When superseded
+    and deleted records take most of the file, the writer compacts it by
+    writing the live records to a new file which replaces it.
+    """
+
+    _magic = b'NUMBAPK2'
+    _header = struct.Struct('<4sIQ')
+    _tag = b'NBR2'
+
+    # Compact files of at least this size whose dead records take more
+    # than this fraction of it
+    _compact_min_size = 1 << 20
+    _compact_ratio = 0.5
+
+    # Open stores, by path
+    _stores = {}
+    _stores_lock = threading.Lock()
+
+    @classmethod
+    def get(cls, path):
+        path = os.path.abspath(path)
+        with cls._stores_lock:
+            store = cls._stores.get(path)
+            if store is None:
+                store = cls._stores[path] = cls(path)
+            return store
+
+    def __init__(self, path):
+        self._path = path
+        self._lock = threading.Lock()
+        self._mmap = None
+        self._file_id = None
+        self._scanned = 0
+        # Total size of the live records
+        self._live_size = 0
+        # filename_base -> {key: (record offset, data offset, record end)}
+        self._entries = {}
+
+    def _refresh(self):
+        """
+        Map the file again and index the records appended since the last
+        time, if it changed.
+        """
+        try:
+            st = os.stat(self._path)
+        except FileNotFoundError:
+            self._reset()
+            return
+        file_id = (st.st_dev, st.st_ino)
+        if file_id != self._file_id or st.st_size < self._scanned:
+            # Compacted or replaced by another process
+            self._reset()
+            self._file_id = file_id
+        if self._mmap is not None and st.st_size == len(self._mmap):
+            return
+        if st.st_size < len(self._magic):
+            return
+        with open(self._path, 'rb') as f:
+            mm = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        if mm[:len(self._magic)] != self._magic:
+            mm.close()
+            return
+        self._mmap = mm
+        self._scan()
+
+    def _reset(self):
+        self._mmap = None
+        self._file_id = None
+        self._scanned = 0
+        self._live_size = 0
+        self._entries.clear()
+
+    def _scan(self):
+        mm = self._mmap
+        pos = max(self._scanned, len(self._magic))
+        hsize = self._header.size
+        while pos + hsize <= len(mm):
+            tag, keylen, datalen = self._header.unpack_from(mm, pos)
+            end = pos + hsize + keylen + datalen
+            if tag != self._tag or end > len(mm):
+                # Being appended to, or left truncated by a crash
+                break
+            filename_base, _, key = mm[pos + hsize:
+                                       pos + hsize + keylen].partition(b'\0')
+            entries = self._entries.setdefault(filename_base, {})
+            if datalen:
+                old = entries.get(key)
+                entries[key] = (pos, end - datalen, end)
+                self._live_size += end - pos
+            elif key:
+                old = entries.pop(key, None)
+            else:
+                old = None
+                for start, _, stop in entries.values():
+                    self._live_size -= stop - start
+                entries.clear()
+            if old is not None:
+                self._live_size -= old[2] - old[0]
+            pos = end
+        self._scanned = pos
+
+    def _dead_size(self):
+        return self._scanned - len(self._magic) - self._live_size
+
+    def keys(self, filename_base):
+        """
+        Return the keys of the entries of *filename_base*.
+        """
+        with self._lock:
+            self._refresh()
+            return list(self._entries.get(filename_base, ()))
+
+    def load(self, filename_base, key):
+        """
+        Return the data of the entry with *key* of *filename_base*, as a
+        view of the mapping, or None if there is none.
+        """
+        with self._lock:
+            self._refresh()
+            loc = self._entries.get(filename_base, {}).get(key)
+            if loc is None:
+                return None
+            _, offset, end = loc
+            return memoryview(self._mmap)[offset:end]
+
+    def _record(self, filename_base, key, data):
+        keydata = filename_base + b'\0' + key
+        return (self._header.pack(self._tag, len(keydata), len(data))
+                + keydata + data)
+
+    def append(self, filename_base, key, data, deleted=()):
+        """
+        Append a record for *key* of *filename_base* with the pickled
+        *data*, after records deleting its entries with the *deleted* keys.
+        With an empty *key* and *data*, all its entries are deleted.
+        """
+        records = b''.join([self._record(filename_base, k, b'')
+                            for k in deleted] +
+                           [self._record(filename_base, key, data)])
+        self._write(records)
+
+    def records(self):
+        """
+        Return the (filename_base, key, size) of the live records, in the
+        order they were written, or None if the file isn't a store of this
+        version.
+        """
+        with self._lock:
+            self._refresh()
+            if self._mmap is None:
+                return None
+            records = sorted((start, base, key, end - start)
+                             for base, entries in self._entries.items()
+                             for key, (start, _, end) in entries.items())
+            return [rec[1:] for rec in records]
+
+    def remove(self, keys):
+        """
+        Delete the entries with the (filename_base, key) *keys*, and compact
+        the file.
+        """
+        records = b''.join([self._record(filename_base, key, b'')
+                            for filename_base, key in keys])
+        self._write(records, compact=True)
+
+    def _write(self, records, compact=False):
+        """
+        Append *records* to the file, then compact it if forced to by
+        *compact* or if dead records take most of it.
+        """
+        with self._lock:
+            while True:
+                fd = os.open(self._path, os.O_RDWR | os.O_CREAT, 0o666)
+                with os.fdopen(fd, 'r+b') as f, _locked_file(f):
+                    st = os.fstat(f.fileno())
+                    try:
+                        current = os.stat(self._path)
+                    except FileNotFoundError:
+                        current = None
+                    if (current is None or (st.st_dev, st.st_ino) !=
+                            (current.st_dev, current.st_ino)):
+                        # Compacted by another writer while we waited for
+                        # the lock
+                        continue
+                    if st.st_size < len(self._magic):
+                        f.truncate(0)
+                        f.write(self._magic)
+                    else:
+                        # Drop a record left truncated by a crashed writer
+                        self._refresh()
+                        if self._scanned and self._scanned < st.st_size:
+                            f.truncate(self._scanned)
+                    f.seek(0, os.SEEK_END)
+                    f.write(records)
+                    f.flush()
+                    self._refresh()
+                    if compact or (self._scanned >= self._compact_min_size and
+                                   self._dead_size() >
+                                   self._scanned * self._compact_ratio):
+                        self._compact()
+                    break
+            self._refresh()
+
+    def _compact(self):
+        """
+        Replace the file with one holding only the live records.  Must be
+        called with the file locked.
+        """
+        mm = self._mmap
+        tmpname = '%s.tmp.%d' % (self._path, os.getpid())
+        try:
+            with open(tmpname, 'wb') as f:
+                f.write(self._magic)
+                for entries in self._entries.values():
+                    for start, _, end in entries.values():
+                        f.write(mm[start:end])
+            file_replace(tmpname, self._path)
+        except EnvironmentError:
+            # E.g. the file is mapped by another process on Windows
+            try:
+                os.unlink(tmpname)
+            except OSError:
+                pass
+            return
+        _cache_log("[cache] compacted %r", self._path)
+
+
+class PackedCacheFile(object):
+    """
+    Implements the same interface as IndexDataCacheFile, but keeps the
+    entries in a _PackedStore shared by all the functions cached in the
+    directory (see NUMBA_CACHE_FORMAT).  The data of an entry is the
+    length of its pickled info, the pickled info and the pickled data.
+    """
+    _info_header = struct.Struct('<I')
+
+    def __init__(self, cache_path, filename_base, source_stamp):
+        self._cache_path = cache_path
+        self._filename_base = filename_base.encode('utf-8')
+        name = 'numba-cache.py%d%d%s.nbp' % (sys.version_info[0],
+                                             sys.version_info[1],
+                                             getattr(sys, 'abiflags', ''))
+        self._store_path = os.path.join(cache_path, name)
+        self._source_stamp = source_stamp
+        self._version = numba.__version__
+
+    def _full_key(self, key):
+        # Entries from another Numba version or source file are never found.
+        # The store compares the pickled keys, so equal keys must pickle to
+        # the same bytes whatever the identity of their parts: disable the
+        # pickler's memo.
+        buf = io.BytesIO()
+        pickler = pickle.Pickler(buf, protocol=-1)
+        pickler.fast = True
+        pickler.dump((self._version, self._source_stamp, key))
+        return buf.getvalue()
+
+    def _store(self):
+        return _PackedStore.get(self._store_path)
+
+    def flush(self):
+        self._store().append(self._filename_base, b'', b'')
+
+    def save(self, key, data, superseded=None, info=None):
+        """
+        Save a new cache entry with *key*, *data* and the *info* dict,
+        deleting the entries from another version or source file of the
+        function, and those whose key satisfies the *superseded* predicate.
+        Return the number of bytes written.
+        """
+        store = self._store()
+        full_key = self._full_key(key)
+        deleted = []
+        for k in store.keys(self._filename_base):
+            if k == full_key:
+                continue
+            try:
+                version, stamp, entry_key = pickle.loads(k)
+            except Exception:
+                deleted.append(k)
+                continue
+            if ((version, stamp) != (self._version, self._source_stamp) or
+                    (superseded is not None and superseded(entry_key))):
+                deleted.append(k)
+        info = pickle.dumps(info or {}, protocol=-1)
+        data = (self._info_header.pack(len(info)) + info +
+                _compress_data(pickle.dumps(data, protocol=-1)))
+        store.append(self._filename_base, full_key, data, deleted)
+        _cache_log("[cache] data saved to %r", self._store_path)
+        return len(data)
+
+    def _load_entry(self, key):
+        """
+        Return the pickled info and data of the entry with *key*, as views
+        of the store's mapping, or None.
+        """
+        try:
+            data = self._store().load(self._filename_base,
+                                      self._full_key(key))
+        except EnvironmentError:
+            return
+        if data is None:
+            return
+        size, = self._info_header.unpack_from(data)
+        start = self._info_header.size
+        return data[start:start + size], data[start + size:]
+
+    def lookup(self, key):
+        entry = self._load_entry(key)
+        if entry is not None:
+            return pickle.loads(entry[0])
+
+    def load(self, key):
+        entry = self._load_entry(key)
+        if entry is None:
+            return
+        # Unpickled straight from the mapping, unless compressed
+        data = pickle.loads(_decompress_data(entry[1]))
+        _cache_log("[cache] data loaded from %r", self._store_path)
+        return data
+
+
+# An evictable unit of a cache directory: an overload of an index (with its
+# data file), a record of a packed store (with no path of its own), or a
+# file no index of this version refers to
+_CacheDirEntry = namedtuple('_CacheDirEntry',
+                            ['atime', 'size', 'path', 'index', 'key', 'dead'])
+
+
+class CacheDirectory(object):
+    """
+    Size accounting and least-recently-used eviction of the cache files in
+    the tree of directories under *path*.
+
+    The overloads listed by the index files of this Numba version are
+    evicted one at a time, by the access time of their data file.  The
+    records of packed stores are too, by the order they were saved in, and
+    the store is then compacted.  Other files (indexes and stores of other
+    versions and their data files) are evicted as a whole, by modification
+    time.  Data files which an index of this version supersedes, or whose
+    index is gone, are dead and always pruned.
+
+    As measuring the size of the tree takes a walk, the last measurement is
+    kept in a stamp file at its root (see Cache._evict()).
+    """
+
+    _suffixes = ('.nbi', '.nbc', '.nbp')
+    _size_stamp_name = 'numba-cache-size.txt'
+
+    def __init__(self, path):
+        self._path = path
+
+    @property
+    def path(self):
+        return self._path
+
+    def _walk(self):
+        for dirpath, dirnames, filenames in os.walk(self._path):
+            for fn in filenames:
+                if fn.endswith(self._suffixes):
+                    try:
+                        st = os.stat(os.path.join(dirpath, fn))
+                    except OSError:
+                        # Removed meanwhile
+                        continue
+                    yield dirpath, fn, st
+
+    def size(self):
+        """
+        Return the total size of the cache files, in bytes.
+        """
+        return sum(st.st_size for _, _, st in self._walk())
+
+    def read_size_stamp(self):
+        """
+        Return the (size, saves, time) recorded in the size stamp file: the
+        size of the tree measured at *time*, plus the size of the entries
+        saved since, and their number.  None if there is no valid stamp.
+        """
+        try:
+            with open(os.path.join(self._path, self._size_stamp_name)) as f:
+                size, saves, measured = f.read().split()
+            return int(size), int(saves), float(measured)
+        except (EnvironmentError, ValueError):
+            return None
+
+    def write_size_stamp(self, size, saves, measured):
+        """
+        Record the size of the tree in the size stamp file.
+        """
+        path = os.path.join(self._path, self._size_stamp_name)
+        tmpname = '%s.tmp.%d' % (path, os.getpid())
+        try:
+            with open(tmpname, 'w') as f:
+                f.write('%d %d %r\n' % (size, saves, measured))
+            file_replace(tmpname, path)
+        except EnvironmentError:
+            # Another process got there first, or read-only directory
+            try:
+                os.unlink(tmpname)
+            except OSError:
+                pass
+
+    def _scan(self):
+        """
+        Return the entries of the cache, and the sizes of the index files of
+        this version by path (those are only removed with their last entry).
+        """
+        dirs = {}
+        for dirpath, fn, st in self._walk():
+            dirs.setdefault(dirpath, {})[fn] = st
+        entries = []
+        indexes = {}
+        for dirpath, files in dirs.items():
+            referenced = set()
+            bases = set()
+            for fn, st in files.items():
+                if not fn.endswith('.nbi'):
+                    continue
+                path = os.path.join(dirpath, fn)
+                base = fn[:-len('.nbi')]
+                cache_file = IndexDataCacheFile(dirpath, base, None)
+                try:
+                    index = cache_file._read_index()
+                except Exception:
+                    index = None
+                if index is None:
+                    # Another version, or corrupted
+                    entries.append(_CacheDirEntry(st.st_mtime, st.st_size,
+                                                  path, None, None, False))
+                    continue
+                bases.add(base)
+                indexes[path] = st.st_size
+                stamp, overloads, infos = index
+                for key, data_name in overloads.items():
+                    referenced.add(data_name)
+                    data_st = files.get(data_name)
+                    if data_st is None:
+                        continue
+                    atime = _file_access_time(data_st)
+                    entries.append(_CacheDirEntry(
+                        atime, data_st.st_size,
+                        os.path.join(dirpath, data_name), path, key, False))
+            for fn, st in files.items():
+                path = os.path.join(dirpath, fn)
+                if fn.endswith('.nbc') and fn not in referenced:
+                    base = fn.rsplit('.', 2)[0]
+                    dead = base in bases or base + '.nbi' not in files
+                    entries.append(_CacheDirEntry(st.st_mtime, st.st_size,
+                                                  path, None, None, dead))
+                elif fn.endswith('.nbp'):
+                    try:
+                        records = _PackedStore.get(path).records()
+                    except Exception:
+                        records = None
+                    if records is None:
+                        # Another version, or corrupted
+                        entries.append(_CacheDirEntry(st.st_mtime, st.st_size,
+                                                      path, None, None,
+                                                      False))
+                        continue
+                    indexes[path] = st.st_size - sum(
+                        size for _, _, size in records)
+                    # No access times are recorded: take the records as
+                    # last used in the order they were saved, the last one
+                    # when the store was last modified
+                    for i, (base, key, size) in enumerate(reversed(records)):
+                        entries.append(_CacheDirEntry(
+                            st.st_mtime - i * 1e-6, size, None, path,
+                            (base, key), False))
+        return entries, indexes
+
+    def stats(self):
+        """
+        Return a dict of statistics about the cache: the number of
+        functions and overloads indexed, the total size, the number and
+        size of dead files and of other files, and the oldest and newest
+        access times.
+        """
+        entries, indexes = self._scan()
+        live = [e for e in entries if e.index is not None]
+        dead = [e for e in entries if e.dead]
+        other = [e for e in entries if e.index is None and not e.dead]
+        atimes = [e.atime for e in live + other]
+        functions = set(path for path in indexes if path.endswith('.nbi'))
+        functions.update((e.index, e.key[0]) for e in live
+                         if e.index.endswith('.nbp'))
+        return {
+            'functions': len(functions),
+            'overloads': len(live),
+            'size': sum(indexes.values()) + sum(e.size for e in entries),
+            'dead_files': len(dead),
+            'dead_size': sum(e.size for e in dead),
+            'other_files': len(other),
+            'other_size': sum(e.size for e in other),
+            'oldest_access': min(atimes) if atimes else None,
+            'newest_access': max(atimes) if atimes else None,
+        }
+
+    def prune(self, max_size=None):
+        """
+        Remove the dead files then, if *max_size* is given, the least
+        recently used entries until the cache takes at most *max_size*
+        bytes.  Return the number of files removed and of bytes freed.
+        """
+        entries, indexes = self._scan()
+        removed = [e for e in entries if e.dead]
+        if max_size is not None:
+            total = sum(indexes.values()) + sum(e.size for e in entries)
+            total -= sum(e.size for e in removed)
+            for e in sorted(entries, key=lambda e: e.atime):
+                if total <= max_size:
+                    break
+                if not e.dead:
+                    removed.append(e)
+                    total -= e.size
+        # Drop the overloads from their indexes first, so that no index
+        # refers to a removed data file
+        keys = {}
+        for e in removed:
+            if e.index is not None:
+                keys.setdefault(e.index, []).append(e.key)
+        nfiles = nbytes = 0
+        for path, index_keys in keys.items():
+            if path.endswith('.nbp'):
+                nbytes += self._drop_records(path, index_keys)
+            elif self._drop_overloads(path, index_keys):
+                nfiles += 1
+                nbytes += indexes[path]
+        for e in removed:
+            if e.path is None:
+                # A record, dropped above
+                continue
+            try:
+                os.unlink(e.path)
+            except OSError:
+                continue
+            nfiles += 1
+            nbytes += e.size
+        _cache_log("[cache] pruned %d files (%d bytes) from %r",
+                   nfiles, nbytes, self._path)
+        return nfiles, nbytes
+
+    def _drop_records(self, path, keys):
+        """
+        Remove the records with (filename_base, key) *keys* from the packed
+        store at *path*.  Return the number of bytes freed.
+        """
+        try:
+            size = os.path.getsize(path)
+            _PackedStore.get(path).remove(keys)
+            return max(size - os.path.getsize(path), 0)
+        except Exception:
+            # Concurrently modified or removed
+            return 0
+
+    def _drop_overloads(self, path, keys):
+        """
+        Remove the overloads with *keys* from the index at *path*, and the
+        index itself if none remains.  Return whether it was removed.
+        """
+        dirpath, fn = os.path.split(path)
+        base = fn[:-len('.nbi')]
+        try:
+            index = IndexDataCacheFile(dirpath, base, None)._read_index()
+            if index is None:
+                return False
+            stamp, overloads, infos = index
+            for key in keys:
+                overloads.pop(key, None)
+                infos.pop(key, None)
+            if overloads:
+                cache_file = IndexDataCacheFile(dirpath, base, stamp)
+                cache_file._save_index(overloads, infos)
+                return False
+            os.unlink(path)
+        except Exception:
+            # Concurrently modified or removed
+            return False
+        return True
+
+
 class Cache(_Cache):
     """
     A per-function compilation cache.  The cache saves data in separate
@@ -596,9 +1573,9 @@ class Cache(_Cache):
 
     There is one index file per function and Python version
     ("function_name-<lineno>.pyXY.nbi") which contains a mapping of
-    signatures and architectures to data files.
-    It is prefixed by a versioning key and a timestamp of the Python source
-    file containing the function.
+    signatures, architectures and hashes of the function's code and
+    dependencies to data files.
+    It is prefixed by a versioning key and the locator's source stamp.
 
     There is one data file ("function_name-<lineno>.pyXY.<number>.nbc")
     per function, function signature, target architecture and Python version.
@@ -622,9 +1599,16 @@ class Cache(_Cache):
         # This may be a bit strict but avoids us maintaining a magic number
         source_stamp = self._impl.locator.get_source_stamp()
         filename_base = self._impl.filename_base
-        self._cache_file = IndexDataCacheFile(cache_path=self._cache_path,
-                                              filename_base=filename_base,
-                                              source_stamp=source_stamp)
+        if config.CACHE_FORMAT == 'packed':
+            cache_file_class = PackedCacheFile
+        else:
+            cache_file_class = IndexDataCacheFile
+        self._cache_file = cache_file_class(cache_path=self._cache_path,
+                                            filename_base=filename_base,
+                                            source_stamp=source_stamp)
+        # The hashes of the function's code and dependencies, computed on
+        # first use (see _index_key())
+        self._hashes = None
         self.enable()
 
     def __repr__(self):
@@ -641,6 +1625,8 @@ class Cache(_Cache):
         self._enabled = False
 
     def flush(self):
+        # The function is being recompiled, perhaps for new globals
+        self._hashes = None
         self._cache_file.flush()
 
     def load_overload(self, sig, target_context):
@@ -658,11 +1644,35 @@ class Cache(_Cache):
         if not self._enabled:
             return
         key = self._index_key(sig, _get_codegen(target_context))
-        data = self._cache_file.load(key)
+        return self._load_key(key, target_context)
+
+    def _load_key(self, key, target_context):
+        # Other threads can compile while the files are read
+        with global_compiler_lock.released():
+            data = self._cache_file.load(key)
         if data is not None:
             data = self._impl.rebuild(target_context, data)
         return data
 
+    def load_overload_lazily(self, sig, target_context):
+        """
+        Look up the given signature in the cache index, and if present,
+        return a callable loading and recreating the cached object, and the
+        info saved with it.
+        """
+        target_context.refresh()
+        if not self._enabled:
+            return
+        key = self._index_key(sig, _get_codegen(target_context))
+        with self._guard_against_spurious_io_errors():
+            with global_compiler_lock.released():
+                info = self._cache_file.lookup(key)
+            if info is not None:
+                def load():
+                    with self._guard_against_spurious_io_errors():
+                        return self._load_key(key, target_context)
+                return load, info
+
     def save_overload(self, sig, data):
         """
         Save the data for the given signature in the cache.
@@ -677,8 +1687,43 @@ class Cache(_Cache):
             return
         self._impl.locator.ensure_cache_path()
         key = self._index_key(sig, _get_codegen(data))
+        info = self._impl.index_info(data)
         data = self._impl.reduce(data)
-        self._cache_file.save(key, data)
+        superseded = lambda k: self._is_superseded(k, key)
+        with global_compiler_lock.released():
+            nbytes = self._cache_file.save(key, data, superseded, info)
+            self._evict(nbytes)
+
+    # The size of the cache directory tree is measured again after this
+    # many saves or seconds; in between, it is estimated from the stamp
+    _size_rescan_saves = 20
+    _size_rescan_interval = 600
+
+    def _evict(self, nbytes):
+        """
+        Prune the least recently used entries of the cache directory tree
+        if it exceeds NUMBA_CACHE_MAX_SIZE, after saving *nbytes*.
+        """
+        max_size = config.CACHE_MAX_SIZE
+        if max_size <= 0:
+            return
+        max_size <<= 20
+        cache_dir = CacheDirectory(self._impl.locator.get_cache_root())
+        now = time.time()
+        stamp = cache_dir.read_size_stamp()
+        if stamp is not None:
+            size, saves, measured = stamp
+            size += nbytes
+            saves += 1
+            if (size <= max_size and saves < self._size_rescan_saves and
+                    0 <= now - measured < self._size_rescan_interval):
+                cache_dir.write_size_stamp(size, saves, measured)
+                return
+        size = cache_dir.size()
+        if size > max_size:
+            # Leave some headroom, so as not to prune on every save
+            size -= cache_dir.prune(int(max_size * 0.9))[1]
+        cache_dir.write_size_stamp(size, 0, now)
 
     @contextlib.contextmanager
     def _guard_against_spurious_io_errors(self):
@@ -697,20 +1742,25 @@ class Cache(_Cache):
     def _index_key(self, sig, codegen):
         """
         Compute index key for the given signature and codegen.
-        It includes a description of the OS, target architecture and hashes of
-        the bytecode for the function and, if the function has a __closure__,
-        a hash of the cell_contents.
-        """
-        codebytes = self._py_func.__code__.co_code
-        if self._py_func.__closure__ is not None:
-            cvars = tuple([x.cell_contents for x in self._py_func.__closure__])
-            cvarbytes = dumps(cvars)
-        else:
-            cvarbytes = b''
+        It includes a description of the OS, target architecture, a hash of
+        the code of the function, and a hash of its dependencies: the
+        globals, closure variables and defaults it captures, including
+        (transitively) the code and dependencies of the jitted functions
+        among them.  The hashes are computed once, then again after a
+        flush.
+        """
+        if self._hashes is None:
+            self._hashes = _FunctionHasher().hash_function(self._py_func)
+        return (sig, codegen.magic_tuple(), self._hashes)
 
-        hasher = lambda x: hashlib.sha256(x).hexdigest()
-        return (sig, codegen.magic_tuple(), (hasher(codebytes),
-                                             hasher(cvarbytes),))
+    def _is_superseded(self, key, new_key):
+        """
+        Whether the index entry *key* is made obsolete by saving *new_key*,
+        as it was compiled from an earlier version of the function's code.
+        Entries only differing by their dependencies are kept, as e.g.
+        closures of the same function share an index.
+        """
+        return key[:2] == new_key[:2] and key[2][0] != new_key[2][0]
 
 
 class FunctionCache(Cache):
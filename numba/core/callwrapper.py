@@ -137,6 +137,7 @@ class PyCallWrapper(object):
         # Block that returns after erroneous argument unboxing/cleanup
         endblk = builder.append_basic_block("arg.end")
         with builder.goto_block(endblk):
+            self.clear_exports(api)
             builder.ret(api.get_null_object())
 
         # Get the Environment object
@@ -154,6 +155,7 @@ class PyCallWrapper(object):
             else:
                 val = cleanup_manager.add_arg(builder.load(obj), ty)
                 innerargs.append(val)
+        self.clear_exports(api)
 
         if self.release_gil:
             cleanup_manager = _GilManager(builder, api, cleanup_manager)
@@ -170,16 +172,34 @@ class PyCallWrapper(object):
         with builder.if_then(status.is_ok, likely=True):
             # Ok => return boxed Python value
             with builder.if_then(status.is_none):
+                self.park_nrt(builder)
                 api.return_none()
 
             retty = self._simplified_return_type()
             obj = api.from_native_return(retty, retval, env_manager)
+            self.park_nrt(builder)
             builder.ret(obj)
 
         # Error out
         self.context.call_conv.raise_error(builder, api, status)
+        self.park_nrt(builder)
         builder.ret(api.get_null_object())
 
+    def clear_exports(self, api):
+        """Drop the array exports kept when typing the arguments, once
+        they are unboxed.
+        """
+        if self.context.enable_nrt:
+            api.nrt_clear_export_caches()
+
+    def park_nrt(self, builder):
+        """Park the thread's NRT state as the thread goes back to the
+        interpreter, so that the MemInfos it owns can be released by other
+        threads while it is idle.
+        """
+        if self.context.enable_nrt:
+            self.context.nrt.park_thread(builder)
+
     def get_env(self, api, builder):
         """Get the Environment object which is declared as a global
         in the module of the wrapped function.
@@ -12,7 +12,8 @@ import llvmlite.ir as llvmir
 from numba.core import utils, config, cgutils
 from numba.core.runtime.nrtopt import remove_redundant_nrt_refct
 from numba.core.runtime import rtsys
-from numba.core.compiler_lock import require_global_compiler_lock
+from numba.core.compiler_lock import (global_compiler_lock,
+                                      require_global_compiler_lock)
 from numba.misc.inspection import disassemble_elf_to_cfg
 
 
@@ -88,11 +89,17 @@ class CodeLibrary(object):
     _finalized = False
     _object_caching_enabled = False
     _disable_inspection = False
+    # Whether the function-level optimization of the IR modules added can
+    # be deferred to finalize() and run without the compiler lock
+    _deferred_optimization = False
 
     def __init__(self, codegen, name):
         self._codegen = codegen
         self._name = name
         self._linking_libraries = []   # maintain insertion order
+        # (module, context) pairs awaiting optimization, see
+        # _optimize_pending_modules()
+        self._pending_modules = []
         self._final_module = ll.parse_assembly(
             str(self._codegen._create_empty_module(self._name)))
         self._final_module.name = cgutils.normalize_ir_text(self._name)
@@ -203,6 +210,15 @@ class CodeLibrary(object):
         self._raise_if_finalized()
         assert isinstance(ir_module, llvmir.Module)
         ir = cgutils.normalize_ir_text(str(ir_module))
+        if self._deferred_optimization and hasattr(ll, 'create_context'):
+            # Each module gets its own LLVM context, as contexts aren't
+            # thread-safe
+            context = ll.create_context()
+            ll_module = ll.parse_assembly(ir, context=context)
+            ll_module.name = ir_module.name
+            ll_module.verify()
+            self._pending_modules.append((ll_module, context))
+            return
         ll_module = ll.parse_assembly(ir)
         ll_module.name = ir_module.name
         ll_module.verify()
@@ -210,10 +226,42 @@ class CodeLibrary(object):
 
     def add_llvm_module(self, ll_module):
         self._optimize_functions(ll_module)
+        self._link_optimized_module(ll_module)
+
+    def _link_optimized_module(self, ll_module):
         # TODO: we shouldn't need to recreate the LLVM module object
         ll_module = remove_redundant_nrt_refct(ll_module)
         self._final_module.link_in(ll_module)
 
+    def _optimize_pending_modules(self):
+        """
+        Internal: run the function-level optimizations of the IR modules
+        whose optimization was deferred, and link them into the final
+        module.  The compiler lock is released while the passes run, as
+        they only touch the modules' own contexts, so that other threads
+        can type and lower their functions meanwhile (llvmlite releases
+        the GIL while the passes run).
+
+        Note the passes themselves don't run in parallel: llvmlite
+        serializes all calls into LLVM with a process-wide lock.
+        """
+        pending, self._pending_modules = self._pending_modules, []
+        if not pending:
+            return
+
+        with global_compiler_lock.released():
+            bitcodes = []
+            for mod, ctx in pending:
+                self._optimize_functions(mod)
+                bitcodes.append(mod.as_bitcode())
+        for (mod, ctx), bitcode in zip(pending, bitcodes):
+            # Move the module back to the global context for linking
+            ll_module = ll.parse_bitcode(bitcode)
+            ll_module.name = mod.name
+            mod.close()
+            ctx.close()
+            self._link_optimized_module(ll_module)
+
     def finalize(self):
         """
         Finalize the library.  After this call, nothing can be added anymore.
@@ -227,6 +275,8 @@ class CodeLibrary(object):
 
         self._raise_if_finalized()
 
+        self._optimize_pending_modules()
+
         if config.DUMP_FUNC_OPT:
             dump("FUNCTION OPTIMIZED DUMP %s" % self._name,
                  self.get_llvm_str(), 'llvm')
@@ -302,6 +352,8 @@ class CodeLibrary(object):
                 yield fn
 
     def get_function(self, name):
+        # Callers may look up (and modify) functions before finalization
+        self._optimize_pending_modules()
         return self._final_module.get_function(name)
 
     def _sentry_cache_disable_inspection(self):
@@ -314,6 +366,7 @@ class CodeLibrary(object):
         Get the human-readable form of the LLVM module.
         """
         self._sentry_cache_disable_inspection()
+        self._optimize_pending_modules()
         return str(self._final_module)
 
     def get_asm_str(self):
@@ -463,6 +516,7 @@ class CodeLibrary(object):
 
 
 class AOTCodeLibrary(CodeLibrary):
+    _deferred_optimization = True
 
     def emit_native_object(self):
         """
@@ -488,6 +542,7 @@ class AOTCodeLibrary(CodeLibrary):
 
 
 class JITCodeLibrary(CodeLibrary):
+    _deferred_optimization = True
 
     def get_pointer_to_function(self, name):
         """
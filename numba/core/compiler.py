@@ -62,6 +62,8 @@ class Flags(utils.ConfigOptions):
         # detail.
         'auto_parallel': cpu.ParallelOptions(False),
         'nrt': False,
+        # Serve NRT allocations from the thread's arena
+        'nrt_arena': False,
         'no_rewrites': False,
         'error_model': 'python',
         'fastmath': cpu.FastMathOptions(False),
@@ -290,6 +292,8 @@ def _make_subtarget(targetctx, flags):
         subtargetoptions['enable_boundscheck'] = True
     if flags.nrt:
         subtargetoptions['enable_nrt'] = True
+    if flags.nrt_arena:
+        subtargetoptions['enable_nrt_arena'] = True
     if flags.auto_parallel:
         subtargetoptions['auto_parallel'] = flags.auto_parallel
     if flags.fastmath:
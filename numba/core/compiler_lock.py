@@ -1,3 +1,4 @@
+import contextlib
 import threading
 import functools
 
@@ -6,13 +7,83 @@ import functools
 class _CompilerLock(object):
     def __init__(self):
         self._lock = threading.RLock()
+        self._local = threading.local()
 
     def acquire(self):
         self._lock.acquire()
+        self._local.depth = self.depth + 1
 
     def release(self):
+        self._local.depth -= 1
         self._lock.release()
 
+    @property
+    def depth(self):
+        """
+        How many times the current thread holds the lock.
+        """
+        return getattr(self._local, 'depth', 0)
+
+    @contextlib.contextmanager
+    def compilation(self):
+        """
+        Hold the lock for the duration of a compilation (e.g. of a
+        dispatcher).  The compilation is top-level if the current thread
+        didn't hold the lock already.
+        """
+        local = self._local
+        outer = (getattr(local, 'top_level', False),
+                 getattr(local, 'pipelines', 0))
+        top_level = self.depth == 0
+        with self:
+            local.top_level, local.pipelines = top_level, 0
+            try:
+                yield
+            finally:
+                local.top_level, local.pipelines = outer
+
+    @contextlib.contextmanager
+    def pipeline(self):
+        """
+        Mark the block as running a compiler pipeline.  Pipelines run
+        while another one is in progress are nested compilations.
+        """
+        local = self._local
+        local.pipelines = getattr(local, 'pipelines', 0) + 1
+        try:
+            yield
+        finally:
+            local.pipelines -= 1
+
+    def _releasable(self):
+        local = self._local
+        if self.depth == 1:
+            return True
+        return (getattr(local, 'top_level', False)
+                and getattr(local, 'pipelines', 0) <= 1)
+
+    @contextlib.contextmanager
+    def released(self):
+        """
+        Release the lock for the duration of the block, if the current
+        thread is in a top-level compilation rather than in a nested one
+        (whose callers may have shared compiler state in flux), or holds
+        the lock exactly once.  All the levels held are released, and
+        reacquired afterwards.  The block mustn't touch the typing and
+        target contexts or LLVM's global context.
+        """
+        if not self._releasable():
+            yield
+            return
+        depth = self.depth
+        for i in range(depth):
+            self.release()
+        try:
+            yield
+        finally:
+            for i in range(depth):
+                self.acquire()
+
     def __enter__(self):
         self.acquire()
 
@@ -180,6 +180,13 @@ class _EnvReloader(object):
         # of external references
         FUNCTION_CACHE_SIZE = _readenv("NUMBA_FUNCTION_CACHE_SIZE", int, 128)
 
+        # Collect per-overload call statistics on all dispatchers
+        CALL_STATS = _readenv("NUMBA_CALL_STATS", int, 0)
+
+        # Limit in bytes on the memory held by live NRT allocations,
+        # 0 means unlimited
+        NRT_MEMORY_LIMIT = _readenv("NUMBA_NRT_MEMORY_LIMIT", int, 0)
+
         # Maximum tuple size that parfors will unpack and pass to
         # internal gufunc.
         PARFOR_MAX_TUPLE_SIZE = _readenv("NUMBA_PARFOR_MAX_TUPLE_SIZE",
@@ -192,6 +199,21 @@ class _EnvReloader(object):
         # Contains path to the directory
         CACHE_DIR = _readenv("NUMBA_CACHE_DIR", str, "")
 
+        # Append the signatures compiled by all dispatchers to this
+        # manifest file (see numba.core.manifest)
+        SIGNATURE_MANIFEST = _readenv("NUMBA_SIGNATURE_MANIFEST", str, "")
+
+        # Cache storage: "files" (an index file per function and a data file
+        # per overload) or "packed" (a single file per cache directory)
+        CACHE_FORMAT = _readenv("NUMBA_CACHE_FORMAT", str, "files")
+
+        # Maximum size of a cache directory tree, in megabytes, beyond which
+        # the least recently used entries are evicted (0 for no limit)
+        CACHE_MAX_SIZE = _readenv("NUMBA_CACHE_MAX_SIZE", int, 0)
+
+        # zlib compression level of the cached data (0 for no compression)
+        CACHE_COMPRESSION = _readenv("NUMBA_CACHE_COMPRESSION", int, 0)
+
         # Enable tracing support
         TRACE = _readenv("NUMBA_TRACE", int, 0)
 
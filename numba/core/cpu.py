@@ -241,6 +241,7 @@ class CPUTargetOptions(TargetOptions):
         "boundscheck": bool,
         "debug": bool,
         "_nrt": bool,
+        "arena": bool,
         "no_rewrites": bool,
         "no_cpython_wrapper": bool,
         "no_cfunc_wrapper": bool,
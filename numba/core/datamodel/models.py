@@ -882,6 +882,38 @@ class ArrayFlagsModel(StructModel):
         super(ArrayFlagsModel, self).__init__(dmm, fe_type, members)
 
 
+@register_default(types.DLPackCapsule)
+class DLPackCapsuleModel(StructModel):
+    def __init__(self, dmm, fe_type):
+        members = [
+            ('array', fe_type.array_type),
+        ]
+        super(DLPackCapsuleModel, self).__init__(dmm, fe_type, members)
+
+
+@register_default(types.ArrowArray)
+class ArrowArrayModel(StructModel):
+    def __init__(self, dmm, fe_type):
+        if fe_type.is_string:
+            values = types.CPointer(types.uint8)
+            offsets = types.CPointer(types.int64 if fe_type.format == 'U'
+                                     else types.int32)
+        else:
+            values = types.CPointer(fe_type.dtype)
+            offsets = types.voidptr
+        members = [
+            ('meminfo', types.MemInfoPointer(types.voidptr)),
+            ('parent', types.pyobject),
+            ('length', types.intp),
+            ('offset', types.intp),
+            ('null_count', types.intp),
+            ('validity', types.CPointer(types.uint8)),
+            ('values', values),
+            ('offsets', offsets),
+        ]
+        super(ArrowArrayModel, self).__init__(dmm, fe_type, members)
+
+
 @register_default(types.NestedArray)
 class NestedArrayModel(ArrayModel):
     def __init__(self, dmm, fe_type):
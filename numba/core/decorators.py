@@ -24,7 +24,7 @@ _msg_deprecated_signature_arg = ("Deprecated keyword argument `{0}`. "
                                  "positional argument.")
 
 def jit(signature_or_function=None, locals={}, cache=False,
-        pipeline_class=None, boundscheck=False, **options):
+        pipeline_class=None, boundscheck=False, background=False, **options):
     """
     This decorator is used to compile a Python function into native code.
 
@@ -48,6 +48,12 @@ def jit(signature_or_function=None, locals={}, cache=False,
     pipeline_class: type numba.compiler.CompilerBase
             The compiler pipeline type for customizing the compilation stages.
 
+    background: bool
+        Set to True to compile the specializations for new argument types
+        on a background thread.  Meanwhile, the calls run an existing
+        specialization the arguments safely convert to, or the Python
+        function.  Default value is False.
+
     options:
         For a cpu target, valid options are:
             nopython: bool
@@ -94,6 +100,12 @@ def jit(signature_or_function=None, locals={}, cache=False,
                 debugging. You can also set the NUMBA_BOUNDSCHECK environment
                 variable to 0 or 1 to globally override this flag.
 
+            arena: bool
+                Set to True to serve the arrays allocated by the function from
+                a per-thread arena instead of individual system allocations.
+                This speeds up functions that create many short-lived
+                temporary arrays. Default value is False.
+
     Returns
     --------
     A callable usable as a compiled function.  Actual compiling will be
@@ -175,14 +187,16 @@ def jit(signature_or_function=None, locals={}, cache=False,
     if pipeline_class is not None:
         dispatcher_args['pipeline_class'] = pipeline_class
     wrapper = _jit(sigs, locals=locals, target=target, cache=cache,
-                   targetoptions=options, **dispatcher_args)
+                   targetoptions=options, background=background,
+                   **dispatcher_args)
     if pyfunc is not None:
         return wrapper(pyfunc)
     else:
         return wrapper
 
 
-def _jit(sigs, locals, target, cache, targetoptions, **dispatcher_args):
+def _jit(sigs, locals, target, cache, targetoptions, background=False,
+         **dispatcher_args):
 
     def wrapper(func, dispatcher):
         if config.ENABLE_CUDASIM and target == 'cuda':
@@ -198,6 +212,8 @@ def _jit(sigs, locals, target, cache, targetoptions, **dispatcher_args):
                           **dispatcher_args)
         if cache:
             disp.enable_caching()
+        if background:
+            disp.enable_background_compile()
         if sigs is not None:
             # Register the Dispatcher to the type inference mechanism,
             # even though the decorator hasn't returned yet.
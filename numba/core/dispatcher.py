@@ -2,10 +2,13 @@
 
 
 import collections
+import concurrent.futures
 import functools
 import os
 import struct
 import sys
+import threading
+import time
 import types as pytypes
 import uuid
 import weakref
@@ -20,7 +23,7 @@ from numba.core.typing.typeof import Purpose, typeof
 from numba.core.bytecode import get_code_object
 from numba.core.utils import reraise
 from numba.core.caching import NullCache, FunctionCache
-from numba.core import entrypoints
+from numba.core import entrypoints, manifest
 
 
 class OmittedArg(object):
@@ -165,20 +168,125 @@ _CompileStats = collections.namedtuple(
     '_CompileStats', ('cache_path', 'cache_hits', 'cache_misses'))
 
 
+class _ResolutionStats(collections.namedtuple(
+        '_ResolutionStats', ('hits', 'misses', 'size'))):
+    """
+    Statistics of a dispatcher's exact-signature resolution cache.
+    """
+    __slots__ = ()
+
+    @property
+    def hit_rate(self):
+        total = self.hits + self.misses
+        return self.hits / total if total else 0.0
+
+
+class _CallStats(collections.namedtuple(
+        '_CallStats', ('calls', 'total_time', 'histogram'))):
+    """
+    Call statistics of a compiled overload.  *total_time* is in seconds;
+    *histogram* is a tuple of (low, high, count) for the non-empty
+    power-of-two latency bins, with bounds in seconds.
+    """
+    __slots__ = ()
+
+    @property
+    def mean_time(self):
+        return self.total_time / self.calls if self.calls else 0.0
+
+
+# Reference point to calibrate the clock used for call statistics
+_clock_origin = (_dispatcher.clock_ticks(), time.perf_counter())
+
+
+def _clock_frequency():
+    """
+    Return the number of call statistics clock ticks per second.
+    """
+    ticks0, t0 = _clock_origin
+    # Make sure the measurement is long enough to be accurate
+    while time.perf_counter() - t0 < 1e-3:
+        pass
+    ticks1, t1 = _dispatcher.clock_ticks(), time.perf_counter()
+    return (ticks1 - ticks0) / (t1 - t0)
+
+
+# Thread compiling the specializations requested by dispatchers in
+# background compilation mode (compilations are serialized by the global
+# compiler lock anyway, so one thread is enough).
+_background_executor = None
+_background_executor_lock = threading.Lock()
+
+
+def _get_background_executor():
+    global _background_executor
+    with _background_executor_lock:
+        if _background_executor is None:
+            _background_executor = concurrent.futures.ThreadPoolExecutor(
+                max_workers=1, thread_name_prefix='numba-compile')
+        return _background_executor
+
+
+class _LazyCompileResult(object):
+    """
+    Stands for an overload found in the disk cache, until something needs
+    it: its entry point loads it when called, and so does accessing any
+    other attribute, which is then forwarded to the loaded compile result.
+    The signature and mode are known from the cache index.
+    """
+
+    def __init__(self, dispatcher, sig, args, loader, info):
+        self._dispatcher = dispatcher
+        self._sig = sig
+        self._args = args
+        self._loader = loader
+        self._signature = info.get('signature')
+        self.objectmode = info.get('objectmode', False)
+        self.interpmode = info.get('interpmode', False)
+        self.entry_point = _dispatcher.make_lazy_overload(
+            self._load_entry_point)
+
+    @property
+    def signature(self):
+        if self._signature is None:
+            # Not in the index
+            return self.load().signature
+        return self._signature
+
+    def _load_entry_point(self):
+        return self.load().entry_point
+
+    def load(self):
+        """
+        Load the overload and return its compile result.
+        """
+        return self._dispatcher._load_lazy_overload(self._args)
+
+    def __getattr__(self, name):
+        if name.startswith('__'):
+            raise AttributeError(name)
+        return getattr(self.load(), name)
+
+
 class _CompilingCounter(object):
     """
     A simple counter that increment in __enter__ and decrement in __exit__.
+    The count is per thread, as it tells whether a call is recursive.
     """
 
     def __init__(self):
-        self.counter = 0
+        self._local = threading.local()
+
+    @property
+    def counter(self):
+        return getattr(self._local, 'counter', 0)
 
     def __enter__(self):
         assert self.counter >= 0
-        self.counter += 1
+        self._local.counter = self.counter + 1
 
     def __exit__(self, *args, **kwargs):
-        self.counter -= 1
+        self._local.counter = self.counter - 1
         assert self.counter >= 0
 
     def __bool__(self):
@@ -194,6 +302,11 @@ class _DispatcherBase(_dispatcher.Dispatcher):
 
     __numba__ = "py_func"
 
+    def __init_subclass__(cls, **kwargs):
+        super().__init_subclass__(**kwargs)
+        # Use the C vectorcall entry point unless __call__ is overridden
+        _dispatcher.enable_vectorcall(cls)
+
     def __init__(self, arg_count, py_func, pysig, can_fallback,
                  exact_match_required):
         self._tm = default_type_manager
@@ -216,6 +329,7 @@ class _DispatcherBase(_dispatcher.Dispatcher):
             has_stararg = False
         else:
             has_stararg = lastarg.kind == lastarg.VAR_POSITIONAL
+        self._has_stararg = has_stararg
         _dispatcher.Dispatcher.__init__(self, self._tm.get_pointer(),
                                         arg_count, self._fold_args,
                                         argnames, defargs,
@@ -225,6 +339,10 @@ class _DispatcherBase(_dispatcher.Dispatcher):
 
         self.doc = py_func.__doc__
         self._compiling_counter = _CompilingCounter()
+        self._compile_lock = threading.RLock()
+        self._retired_entry_points = []
+        self._collect_stats = bool(config.CALL_STATS)
+        self._background_compile = False
         weakref.finalize(self, self._make_finalizer())
 
     def _compilation_chain_init_hook(self):
@@ -275,9 +393,52 @@ class _DispatcherBase(_dispatcher.Dispatcher):
 
     @property
     def nopython_signatures(self):
-        return [cres.signature for cres in self.overloads.values()
+        return [cres.signature for cres in list(self.overloads.values())
                 if not cres.objectmode and not cres.interpmode]
 
+    @property
+    def resolution_stats(self):
+        """
+        Statistics of the cache mapping the argument types of a call to
+        the compiled overload: a (hits, misses, size) namedtuple with a
+        `hit_rate` property.  The cache is flushed whenever an overload
+        is added.
+        """
+        return _ResolutionStats(*self._resolution_cache_stats())
+
+    def enable_call_stats(self, enabled=True):
+        """
+        Start (or stop) collecting the statistics returned by
+        call_stats().  Collection is disabled by default, unless the
+        NUMBA_CALL_STATS environment variable is set.
+        """
+        self._collect_stats = enabled
+
+    def reset_call_stats(self):
+        """
+        Discard the statistics collected so far.
+        """
+        self._reset_call_stats()
+
+    def call_stats(self):
+        """
+        Return the statistics of calls from Python, as a dict mapping the
+        signatures of the overloads called since collection was enabled
+        to a (calls, total_time, histogram) namedtuple.
+        """
+        freq = _clock_frequency()
+        sigs = dict((cres.entry_point, sig)
+                    for sig, cres in self.overloads.items())
+        res = {}
+        for cfunc, calls, ticks, hist in self._call_stats():
+            sig = sigs.get(cfunc)
+            if sig is None:
+                continue
+            bins = tuple((2 ** i / freq if i else 0.0, 2 ** (i + 1) / freq, n)
+                         for i, n in enumerate(hist) if n)
+            res[sig] = _CallStats(calls, ticks / freq, bins)
+        return res
+
     def disable_compile(self, val=True):
         """Disable the compilation of new signatures at call time.
         """
@@ -325,7 +486,13 @@ class _DispatcherBase(_dispatcher.Dispatcher):
         Return the compiled function for the given signature.
         """
         args, return_type = sigutils.normalize_signature(sig)
-        return self.overloads[tuple(args)].entry_point
+        return self._get_loaded_overload(tuple(args)).entry_point
+
+    def _get_loaded_overload(self, args):
+        cres = self.overloads[args]
+        if isinstance(cres, _LazyCompileResult):
+            cres = cres.load()
+        return cres
 
     @property
     def is_compiling(self):
@@ -362,7 +529,11 @@ class _DispatcherBase(_dispatcher.Dispatcher):
             if isinstance(a, OmittedArg):
                 argtypes.append(types.Omitted(a.value))
             else:
-                argtypes.append(self.typeof_pyval(a))
+                argtypes.append(self.typeof_pyval(a, keep_exports=False))
+        if self._background_compile:
+            fallback = self._start_background_compile(tuple(argtypes))
+            if fallback is not None:
+                return fallback
         try:
             return self.compile(tuple(argtypes))
         except errors.ForceLiteralArg as e:
@@ -589,7 +760,8 @@ class _DispatcherBase(_dispatcher.Dispatcher):
         Callback for the C _Dispatcher object.
         """
         assert not kws, "kwargs not handled"
-        args = tuple([self.typeof_pyval(a) for a in args])
+        args = tuple([self.typeof_pyval(a, keep_exports=False)
+                      for a in args])
         # The order here must be deterministic for testing purposes, which
         # is ensured by the OrderedDict.
         sigs = self.nopython_signatures
@@ -602,7 +774,7 @@ class _DispatcherBase(_dispatcher.Dispatcher):
         Callback for the C _Dispatcher object.
         """
         assert not kws, "kwargs not handled"
-        args = [self.typeof_pyval(a) for a in args]
+        args = [self.typeof_pyval(a, keep_exports=False) for a in args]
         msg = ("No matching definition for argument type(s) %s"
                % ', '.join(map(str, args)))
         raise TypeError(msg)
@@ -615,7 +787,7 @@ class _DispatcherBase(_dispatcher.Dispatcher):
         type manager.
         """
         assert not kws, "kwargs not handled"
-        args = [self.typeof_pyval(a) for a in args]
+        args = [self.typeof_pyval(a, keep_exports=False) for a in args]
         found = False
         for sig in self.nopython_signatures:
             conv = self.typingctx.install_possible_conversions(args, sig.args)
@@ -626,16 +798,17 @@ class _DispatcherBase(_dispatcher.Dispatcher):
     def __repr__(self):
         return "%s(%s)" % (type(self).__name__, self.py_func)
 
-    def typeof_pyval(self, val):
+    def typeof_pyval(self, val, keep_exports=True):
         """
         Resolve the Numba type of Python value *val*.
         This is called from numba._dispatcher as a fallback if the native code
-        cannot decide the type.
+        cannot decide the type.  The arrays *val* exports for typing are kept
+        for unboxing it if *keep_exports* is true, i.e. when a call follows.
         """
         # Not going through the resolve_argument_type() indirection
         # can save a couple µs.
         try:
-            tp = typeof(val, Purpose.argument)
+            tp = typeof(val, Purpose.argument, keep_exports)
         except ValueError:
             tp = types.pyobject
         else:
@@ -799,8 +972,18 @@ class Dispatcher(serialize.ReduceMixin, _MemoMixin, _DispatcherBase, metaclass=D
         self._can_compile = can_compile
         return self
 
-    @global_compiler_lock
     def compile(self, sig):
+        if global_compiler_lock.depth:
+            # Nested in another compilation
+            with global_compiler_lock.compilation():
+                return self._compile(sig)
+        # Concurrent compilations of this function wait on its own lock,
+        # taken before the global one: whoever comes second finds the
+        # first's result.
+        with self._compile_lock, global_compiler_lock.compilation():
+            return self._compile(sig)
+
+    def _compile(self, sig):
         if not self._can_compile:
             raise RuntimeError("compilation disabled")
         # Use counter to track recursion compilation depth
@@ -810,28 +993,158 @@ class Dispatcher(serialize.ReduceMixin, _MemoMixin, _DispatcherBase, metaclass=D
             existing = self.overloads.get(tuple(args))
             if existing is not None:
                 return existing.entry_point
-            # Try to load from disk cache
-            cres = self._cache.load_overload(sig, self.targetctx)
-            if cres is not None:
+            # Look up the disk cache.  The overload is only loaded when
+            # first called or otherwise needed.
+            cached = self._cache.load_overload_lazily(sig, self.targetctx)
+            if cached is not None:
+                # The compiler lock is released while the cache is read,
+                # so a nested compilation elsewhere may have got there
+                # first.
+                existing = self.overloads.get(tuple(args))
+                if existing is not None:
+                    return existing.entry_point
                 self._cache_hits[sig] += 1
-                # XXX fold this in add_overload()? (also see compiler.py)
-                if not cres.objectmode and not cres.interpmode:
-                    self.targetctx.insert_user_function(cres.entry_point,
-                                                        cres.fndesc, [cres.library])
-                self.add_overload(cres)
+                loader, info = cached
+                cres = _LazyCompileResult(self, sig, tuple(args), loader, info)
+                self._insert([a._code for a in args], cres.entry_point,
+                             cres.objectmode, cres.interpmode)
+                self.overloads[tuple(args)] = cres
+                manifest.record_compilation(self, args)
                 return cres.entry_point
 
             self._cache_misses[sig] += 1
-            try:
-                cres = self._compiler.compile(args, return_type)
-            except errors.ForceLiteralArg as e:
-                def folded(args, kws):
-                    return self._compiler.fold_argument_types(args, kws)[1]
-                raise e.bind_fold_arguments(folded)
-            self.add_overload(cres)
-            self._cache.save_overload(sig, cres)
+            cres = self._compile_fresh(sig, args, return_type)
             return cres.entry_point
 
+    def _compile_fresh(self, sig, args, return_type):
+        try:
+            cres = self._compiler.compile(args, return_type)
+        except errors.ForceLiteralArg as e:
+            def folded(args, kws):
+                return self._compiler.fold_argument_types(args, kws)[1]
+            raise e.bind_fold_arguments(folded)
+        # The compiler lock is released while the code is optimized, so a
+        # nested compilation elsewhere may have got there first.
+        existing = self.overloads.get(tuple(args))
+        if existing is not None:
+            return existing
+        self.add_overload(cres)
+        self._cache.save_overload(sig, cres)
+        manifest.record_compilation(self, args)
+        return cres
+
+    def _load_lazy_overload(self, args):
+        """
+        Load the overload for *args* left in the cache by compile(), and
+        return its compile result.
+        """
+        if global_compiler_lock.depth:
+            with global_compiler_lock.compilation():
+                return self._load_lazy_overload_locked(args)
+        with self._compile_lock, global_compiler_lock.compilation():
+            return self._load_lazy_overload_locked(args)
+
+    def _load_lazy_overload_locked(self, args):
+        lazy = self.overloads[args]
+        if not isinstance(lazy, _LazyCompileResult):
+            # Loaded by another thread meanwhile
+            return lazy
+        cres = lazy._loader()
+        if cres is None:
+            # Removed from the cache in the meantime
+            sig_args, return_type = sigutils.normalize_signature(lazy._sig)
+            with self._compiling_counter:
+                cres = self._compiler.compile(sig_args, return_type)
+            self._cache.save_overload(lazy._sig, cres)
+        elif not cres.objectmode and not cres.interpmode:
+            # XXX fold this in add_overload()? (also see compiler.py)
+            self.targetctx.insert_user_function(cres.entry_point,
+                                                cres.fndesc, [cres.library])
+        # Keep the replaced entry point alive, as it may be running
+        self._retired_entry_points.append(lazy.entry_point)
+        self._replace(lazy.entry_point, cres.entry_point, cres.objectmode,
+                      cres.interpmode)
+        self.overloads[args] = cres
+        return cres
+
+    def enable_background_compile(self):
+        """
+        Compile the specializations for new argument types on a background
+        thread.  Until one is ready, calls with these argument types run an
+        existing specialization the arguments safely convert to, or else the
+        original Python function.
+        """
+        if not self._background_compile:
+            self._background_lock = threading.Lock()
+            self._background_pending = {}
+            self._background_failed = set()
+            self._background_compile = True
+
+    def wait_background_compile(self, timeout=None):
+        """
+        Wait for the pending background compilations to finish.  Return
+        whether they all did before *timeout* seconds.
+        """
+        if not self._background_compile:
+            return True
+        with self._background_lock:
+            futures = list(self._background_pending.values())
+        done, not_done = concurrent.futures.wait(futures, timeout)
+        return not not_done
+
+    def _start_background_compile(self, argtypes):
+        """
+        Schedule the compilation of a specialization for *argtypes* and
+        return the callable to use for the current call, or None if it must
+        be compiled synchronously.
+        """
+        with self._background_lock:
+            # A failed compilation is retried in the foreground, so as
+            # to raise the error to the caller.
+            if argtypes in self._background_failed:
+                return None
+            existing = self.overloads.get(argtypes)
+            if existing is not None:
+                # Finished between the dispatcher lookup and here
+                return existing.entry_point
+            if argtypes not in self._background_pending:
+                executor = _get_background_executor()
+                self._background_pending[argtypes] = executor.submit(
+                    self._compile_in_background, argtypes)
+
+        if self.overloads:
+            try:
+                index = self._tm.select_overload(argtypes,
+                                                 list(self.overloads),
+                                                 allow_unsafe=False,
+                                                 exact_match_required=False)
+            except TypeError:
+                pass
+            else:
+                cres = list(self.overloads.values())[index]
+                return cres.entry_point
+        if self._impl_kind == 'generated':
+            # The Python function returns an implementation
+            return None
+        return self._call_interpreted
+
+    def _compile_in_background(self, argtypes):
+        try:
+            self.compile(argtypes)
+        except Exception:
+            with self._background_lock:
+                self._background_failed.add(argtypes)
+        finally:
+            with self._background_lock:
+                del self._background_pending[argtypes]
+
+    def _call_interpreted(self, *args):
+        # Undo the folding of the arguments by the C dispatcher
+        args = [a.value if isinstance(a, OmittedArg) else a for a in args]
+        if self._has_stararg:
+            args[-1:] = args[-1]
+        return self.py_func(*args)
+
     def get_compile_result(self, sig):
         """Compile (if needed) and return the compilation result with the
         given signature.
@@ -839,7 +1152,7 @@ class Dispatcher(serialize.ReduceMixin, _MemoMixin, _DispatcherBase, metaclass=D
         atypes = tuple(sig.args)
         if atypes not in self.overloads:
             self.compile(atypes)
-        return self.overloads[atypes]
+        return self._get_loaded_overload(atypes)
 
     def recompile(self):
         """
@@ -1115,4 +1428,5 @@ class ObjModeLiftedWith(LiftedWith):
 # Initialize typeof machinery
 _dispatcher.typeof_init(
     OmittedArg,
-    dict((str(t), t._code) for t in types.number_domain))
+    dict([(str(t), t._code) for t in types.number_domain] +
+         [('unicode_type', types.unicode_type._code)]))
@@ -0,0 +1,171 @@
+"""
+Signature manifests: record the signatures compiled by the dispatchers of
+a process, so that a later process can compile (or load from the cache)
+all of them at startup rather than on the first calls.
+
+A manifest is a file of consecutive pickled records
+``(module name, function qualname, argument types)``, appended to by
+every recording process.
+"""
+
+
+import concurrent.futures
+import importlib
+import multiprocessing
+import os
+import pickle
+import threading
+import warnings
+
+from numba.core import config
+from numba.core.errors import NumbaWarning
+
+
+_record_lock = threading.Lock()
+_record_path = None
+_recorded = set()
+
+
+def _read_records(path):
+    records = []
+    try:
+        f = open(path, 'rb')
+    except FileNotFoundError:
+        return records
+    with f:
+        while True:
+            try:
+                records.append(pickle.load(f))
+            except EOFError:
+                break
+            except Exception:
+                # A truncated record from an interrupted process
+                break
+    return records
+
+
+def record_signatures(path):
+    """
+    Start appending the signatures compiled by all dispatchers to the
+    manifest at *path*, or stop recording if *path* is None.  Signatures
+    already in the manifest aren't recorded again.
+    """
+    global _record_path
+    with _record_lock:
+        _recorded.clear()
+        if path is not None:
+            path = os.path.abspath(path)
+            _recorded.update(_read_records(path))
+        _record_path = path
+
+
+def record_compilation(dispatcher, args):
+    """
+    Record that *dispatcher* compiled a specialization for the argument
+    types *args*, if recording.
+    """
+    if _record_path is None:
+        return
+    py_func = dispatcher.py_func
+    qualname = py_func.__qualname__
+    if '<locals>' in qualname or '<lambda>' in qualname:
+        # Can't be found again by name
+        return
+    record = (py_func.__module__, qualname, tuple(args))
+    with _record_lock:
+        if _record_path is None or record in _recorded:
+            return
+        try:
+            data = pickle.dumps(record, protocol=-1)
+        except Exception:
+            return
+        _recorded.add(record)
+        # A single write in append mode, so that the records of concurrent
+        # processes don't interleave
+        fd = os.open(_record_path, os.O_WRONLY | os.O_APPEND | os.O_CREAT,
+                     0o666)
+        try:
+            os.write(fd, data)
+        finally:
+            os.close(fd)
+
+
+def _resolve(modname, qualname):
+    from numba.core.dispatcher import Dispatcher
+
+    obj = importlib.import_module(modname)
+    for name in qualname.split('.'):
+        obj = getattr(obj, name)
+    if not isinstance(obj, Dispatcher):
+        raise TypeError("%s.%s is not a jitted function"
+                        % (modname, qualname))
+    return obj
+
+
+def _compile_record(record):
+    modname, qualname, args = record
+    _resolve(modname, qualname).compile(args)
+
+
+def _compile_in_worker(record):
+    # Run in a child process: only useful for its side effect of filling
+    # the disk cache, so don't report errors.
+    try:
+        _compile_record(record)
+    except Exception:
+        return False
+    return True
+
+
+def load_manifest(path, threads=None, processes=None):
+    """
+    Compile the signatures of the manifest at *path* for their dispatchers,
+    on *threads* threads, and return the number of signatures compiled.
+
+    If *processes* is more than one, the signatures of the dispatchers
+    with caching enabled are first compiled on that many child processes,
+    which save them to the cache for this process to load.  The entries
+    which can't be compiled (e.g. because the function was removed) emit a
+    warning and are skipped.
+    """
+    from numba.core.caching import NullCache
+
+    records = list(dict.fromkeys(_read_records(path)))
+    if not records:
+        return 0
+
+    if processes is not None and processes > 1:
+        cached = []
+        for record in records:
+            modname, qualname, args = record
+            if modname == '__main__':
+                # Not importable by name from a child process
+                continue
+            try:
+                disp = _resolve(modname, qualname)
+            except Exception:
+                continue
+            if not isinstance(disp._cache, NullCache):
+                cached.append(record)
+        if cached:
+            ctx = multiprocessing.get_context('spawn')
+            with ctx.Pool(processes) as pool:
+                pool.map(_compile_in_worker, cached)
+
+    def compile_record(record):
+        try:
+            _compile_record(record)
+        except Exception as e:
+            modname, qualname, args = record
+            msg = ("Cannot compile manifest entry %s.%s%s: %s"
+                   % (modname, qualname, args, e))
+            warnings.warn(msg, NumbaWarning)
+            return False
+        return True
+
+    with concurrent.futures.ThreadPoolExecutor(threads or 1) as executor:
+        return sum(executor.map(compile_record, records))
+
+
+if config.SIGNATURE_MANIFEST:
+    record_signatures(config.SIGNATURE_MANIFEST)
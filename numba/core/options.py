@@ -49,6 +49,9 @@ class TargetOptions(object):
         if kws.pop('_nrt', True):
             flags.set("nrt")
 
+        if kws.pop('arena', False):
+            flags.set("nrt_arena")
+
         if kws.pop('debug', config.DEBUGINFO_DEFAULT):
             flags.set("debuginfo")
             flags.set("boundscheck")
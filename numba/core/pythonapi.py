@@ -6,6 +6,7 @@ import hashlib
 from llvmlite import ir
 from llvmlite.llvmpy.core import Type, Constant
 import llvmlite.llvmpy.core as lc
+import numpy as np
 
 import ctypes
 from numba import _helperlib
@@ -1189,8 +1190,13 @@ class PythonAPI(object):
         assert self.context.enable_nrt, "NRT required"
 
         intty = ir.IntType(32)
-        # Embed the Python type of the array (maybe subclass) in the LLVM.
-        serial_aryty_pytype = self.unserialize(self.serialize_object(aryty.py_type))
+        if aryty.py_type is np.ndarray:
+            # Common case, let the C helper avoid unpickling the type
+            serial_aryty_pytype = self.get_null_object()
+        else:
+            # Embed the Python type of the array (maybe subclass) in the LLVM.
+            serial_aryty_pytype = self.unserialize(
+                self.serialize_object(aryty.py_type))
 
         fnty = Type.function(self.pyobj,
                              [self.voidptr, self.pyobj, intty, intty, self.pyobj])
@@ -1206,6 +1212,28 @@ class PythonAPI(object):
                                       serial_aryty_pytype,
                                       ndim, writable, dtypeptr])
 
+    def nrt_adapt_ndarray_to_dlpack(self, aryty, ary):
+        """
+        Export the native array *ary* as a DLPack capsule.  The NRT
+        reference to the array is stolen.
+        """
+        assert self.context.enable_nrt, "NRT required"
+
+        from numba.np.numpy_support import as_dlpack_dtype
+
+        intty = ir.IntType(32)
+        fnty = Type.function(self.pyobj,
+                             [self.voidptr, intty, intty, intty])
+        fn = self._get_function(fnty, name="NRT_adapt_ndarray_to_dlpack")
+        fn.args[0].add_attribute(lc.ATTR_NO_CAPTURE)
+
+        code, bits = as_dlpack_dtype(aryty.dtype)
+        aryptr = cgutils.alloca_once_value(self.builder, ary)
+        return self.builder.call(fn, [self.builder.bitcast(aryptr,
+                                                           self.voidptr),
+                                      intty(aryty.ndim), intty(code),
+                                      intty(bits)])
+
     def nrt_meminfo_new_from_pyobject(self, data, pyobj):
         """
         Allocate a new MemInfo with data payload borrowed from a python
@@ -1259,6 +1287,46 @@ class PythonAPI(object):
         fn.args[1].add_attribute(lc.ATTR_NO_CAPTURE)
         return self.builder.call(fn, (ary, ptr))
 
+    def nrt_adapt_array_from_python(self, ary, ndim, itemsize, ptr):
+        """
+        Like nrt_adapt_ndarray_from_python(), also adopting the tensor
+        exported by *ary* through DLPack if it has *ndim* dimensions and
+        *itemsize* bytes items (unchecked if 0).
+        """
+        assert self.context.enable_nrt
+        fnty = Type.function(Type.int(), [self.pyobj, Type.int(), Type.int(),
+                                          self.voidptr])
+        fn = self._get_function(fnty, name="NRT_adapt_array_from_python")
+        fn.args[0].add_attribute(lc.ATTR_NO_CAPTURE)
+        fn.args[3].add_attribute(lc.ATTR_NO_CAPTURE)
+        return self.builder.call(fn, (ary, Constant.int(Type.int(), ndim),
+                                      Constant.int(Type.int(), itemsize),
+                                      ptr))
+
+    def nrt_clear_export_caches(self):
+        """
+        Drop the array exports kept for typing the arguments of the call
+        that unboxing didn't take.
+        """
+        assert self.context.enable_nrt
+        fnty = Type.function(Type.void(), ())
+        fn = self._get_function(fnty, name="NRT_clear_export_caches")
+        return self.builder.call(fn, ())
+
+    def nrt_adapt_arrow_from_python(self, obj, format, ptr):
+        """
+        Adopt the array exported by *obj* through the Arrow C Data
+        Interface, checking it has the given *format*.
+        """
+        assert self.context.enable_nrt
+        fnty = Type.function(Type.int(), [self.pyobj, self.cstring,
+                                          self.voidptr])
+        fn = self._get_function(fnty, name="NRT_adapt_arrow_from_python")
+        fn.args[0].add_attribute(lc.ATTR_NO_CAPTURE)
+        fn.args[2].add_attribute(lc.ATTR_NO_CAPTURE)
+        fmt = self.context.insert_const_string(self.module, format)
+        return self.builder.call(fn, (obj, fmt, ptr))
+
     def nrt_adapt_buffer_from_python(self, buf, ptr):
         assert self.context.enable_nrt
         fnty = Type.function(Type.void(), [Type.pointer(self.py_buffer_t),
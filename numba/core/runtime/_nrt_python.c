@@ -4,6 +4,7 @@
  */
 
 #include "../../_pymodule.h"
+#include <stdint.h>
 
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
 #include <numpy/ndarrayobject.h>
@@ -60,6 +61,8 @@ int MemInfo_init(MemInfoObject *self, PyObject *args, PyObject *kwds) {
     if(PyErr_Occurred()) return -1;
     self->meminfo = (NRT_MemInfo *)raw_ptr;
     assert (NRT_MemInfo_refcount(self->meminfo) > 0 && "0 refcount");
+    /* The Python object may be released from any thread */
+    NRT_MemInfo_share(self->meminfo);
     return 0;
 }
 
@@ -240,6 +243,474 @@ NRT_meminfo_from_pyobject(MemInfoObject *miobj) {
 }
 
 
+/*
+ * Exports made when typing an argument for a call, kept for unboxing it so
+ * that the producer is only asked to export once per call.  Each cache maps
+ * id(obj) to an (obj, export) tuple, keeping `obj` alive so that its id
+ * can't be reused.  Unboxing consumes the entry; as an argument may be typed
+ * and never unboxed, the entries left are dropped once the arguments of the
+ * call are unboxed (see NRT_clear_export_caches()), and the oldest entries
+ * beyond NRT_EXPORT_CACHE_SIZE.  The GIL protects the caches.
+ */
+
+#define NRT_EXPORT_CACHE_SIZE  16
+
+static PyObject *dlpack_export_cache = NULL;
+static PyObject *arrow_export_cache = NULL;
+
+/* Remember `export` for `obj`.  Returns -1 with an exception set on error */
+static int
+nrt_export_cache_put(PyObject **cache, PyObject *obj, PyObject *export) {
+    PyObject *key, *value;
+    int res;
+
+    if (*cache == NULL) {
+        *cache = PyDict_New();
+        if (*cache == NULL)
+            return -1;
+    }
+    while (PyDict_Size(*cache) >= NRT_EXPORT_CACHE_SIZE) {
+        Py_ssize_t pos = 0;
+        PyObject *oldest;
+        PyDict_Next(*cache, &pos, &oldest, NULL);
+        if (PyDict_DelItem(*cache, oldest))
+            return -1;
+    }
+    key = PyLong_FromVoidPtr(obj);
+    if (key == NULL)
+        return -1;
+    value = PyTuple_Pack(2, obj, export);
+    if (value == NULL) {
+        Py_DECREF(key);
+        return -1;
+    }
+    /* Delete first, so that a replaced entry becomes the newest */
+    if (PyDict_DelItem(*cache, key))
+        PyErr_Clear();
+    res = PyDict_SetItem(*cache, key, value);
+    Py_DECREF(key);
+    Py_DECREF(value);
+    return res;
+}
+
+/*
+ * Drop the exports no unboxing has taken, as they pin their objects.
+ * Called with the GIL held once the arguments of a call are unboxed.
+ */
+NUMBA_EXPORT_FUNC(void)
+NRT_clear_export_caches(void)
+{
+    if (dlpack_export_cache != NULL && PyDict_Size(dlpack_export_cache))
+        PyDict_Clear(dlpack_export_cache);
+    if (arrow_export_cache != NULL && PyDict_Size(arrow_export_cache))
+        PyDict_Clear(arrow_export_cache);
+}
+
+/*
+ * Take the export remembered for `obj`, as a new reference.  Returns NULL,
+ * without an exception set, if there is none.
+ */
+static PyObject *
+nrt_export_cache_take(PyObject *cache, PyObject *obj) {
+    PyObject *key, *value, *export = NULL;
+
+    if (cache == NULL || PyDict_Size(cache) == 0)
+        return NULL;
+    key = PyLong_FromVoidPtr(obj);
+    if (key == NULL) {
+        PyErr_Clear();
+        return NULL;
+    }
+    value = PyDict_GetItem(cache, key);
+    if (value != NULL) {
+        export = PyTuple_GET_ITEM(value, 1);
+        Py_INCREF(export);
+        if (PyDict_DelItem(cache, key))
+            PyErr_Clear();
+    }
+    Py_DECREF(key);
+    return export;
+}
+
+/*
+ * DLPack support (https://github.com/dmlc/dlpack).
+ * The structures below are the ones from dlpack.h; only CPU tensors are
+ * supported.
+ */
+
+#define NRT_DLPACK_CPU  1       /* kDLCPU */
+
+typedef struct {
+    int32_t device_type;
+    int32_t device_id;
+} DLDevice;
+
+typedef struct {
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+} DLDataType;
+
+typedef struct {
+    void *data;
+    DLDevice device;
+    int32_t ndim;
+    DLDataType dtype;
+    int64_t *shape;
+    int64_t *strides;   /* in items, NULL for C-contiguous */
+    uint64_t byte_offset;
+} DLTensor;
+
+typedef struct DLManagedTensor {
+    DLTensor dl_tensor;
+    void *manager_ctx;
+    void (*deleter)(struct DLManagedTensor *self);
+} DLManagedTensor;
+
+static void
+dlpack_dtor(void *ptr, size_t size, void *info) {
+    DLManagedTensor *managed = info;
+    if (managed->deleter)
+        managed->deleter(managed);
+}
+
+/*
+ * Get the DLManagedTensor of a "dltensor" capsule, or NULL if it isn't a
+ * supported CPU tensor.  No exception is set.
+ */
+static DLManagedTensor *
+dlpack_capsule_tensor(PyObject *capsule) {
+    DLManagedTensor *managed;
+    DLTensor *t;
+
+    managed = PyCapsule_GetPointer(capsule, "dltensor");
+    if (managed == NULL) {
+        PyErr_Clear();
+        return NULL;
+    }
+    t = &managed->dl_tensor;
+    if (t->device.device_type != NRT_DLPACK_CPU || t->dtype.lanes != 1 ||
+        t->dtype.bits == 0 || t->dtype.bits % 8 != 0 || t->ndim < 0)
+        return NULL;
+    return managed;
+}
+
+/*
+ * Adopt the tensor exported by `obj.__dlpack__()` as a native array of
+ * `ndim` dimensions and `itemsize` bytes items (not checked if 0).
+ * Returns -1, without an exception set, if `obj` doesn't export a
+ * supported tensor of that type.
+ */
+static int
+adapt_dlpack_from_python(PyObject *obj, int ndim, npy_intp itemsize,
+                         arystruct_t *arystruct) {
+    PyObject *capsule;
+    DLManagedTensor *managed;
+    DLTensor *t;
+    npy_intp *p, stride;
+    int i;
+
+    /* Reuse the capsule exported for typing, if any */
+    capsule = nrt_export_cache_take(dlpack_export_cache, obj);
+    if (capsule == NULL)
+        capsule = PyObject_CallMethod(obj, "__dlpack__", NULL);
+    if (capsule == NULL) {
+        PyErr_Clear();
+        return -1;
+    }
+    managed = dlpack_capsule_tensor(capsule);
+    /* The tensor may not be the one seen when typing `obj`, and it must
+       fit in the native array structure */
+    if (managed != NULL &&
+        (managed->dl_tensor.ndim != ndim ||
+         (itemsize && managed->dl_tensor.dtype.bits / 8 != itemsize)))
+        managed = NULL;
+    /* Mark the capsule as consumed: its deleter is now ours to call */
+    if (managed == NULL || PyCapsule_SetName(capsule, "used_dltensor")) {
+        PyErr_Clear();
+        Py_DECREF(capsule);
+        return -1;
+    }
+    Py_DECREF(capsule);
+
+    t = &managed->dl_tensor;
+    itemsize = t->dtype.bits / 8;
+    arystruct->meminfo = NRT_MemInfo_new(t->data, 0, dlpack_dtor, managed);
+    if (arystruct->meminfo == NULL) {
+        managed->deleter(managed);
+        PyErr_NoMemory();
+        return -1;
+    }
+    arystruct->data = (char *) t->data + t->byte_offset;
+    arystruct->nitems = 1;
+    arystruct->itemsize = itemsize;
+    arystruct->parent = obj;
+    p = arystruct->shape_and_strides;
+    for (i = 0; i < t->ndim; i++) {
+        p[i] = (npy_intp) t->shape[i];
+        arystruct->nitems *= p[i];
+    }
+    p += t->ndim;
+    stride = itemsize;
+    for (i = t->ndim - 1; i >= 0; i--) {
+        if (t->strides) {
+            p[i] = (npy_intp) t->strides[i] * itemsize;
+        }
+        else {
+            p[i] = stride;
+            stride *= (npy_intp) t->shape[i];
+        }
+    }
+
+    NRT_Debug(nrt_debug_print("adapt_dlpack_from_python %p\n",
+                              arystruct->meminfo));
+    return 0;
+}
+
+static void
+dlpack_export_deleter(DLManagedTensor *self) {
+    if (self->manager_ctx)
+        NRT_MemInfo_release((NRT_MemInfo *) self->manager_ctx);
+    NRT_Free(self);
+}
+
+static void
+dlpack_capsule_destructor(PyObject *capsule) {
+    DLManagedTensor *managed;
+    /* Only delete the tensor if no consumer took it over */
+    if (PyCapsule_IsValid(capsule, "dltensor")) {
+        managed = PyCapsule_GetPointer(capsule, "dltensor");
+        managed->deleter(managed);
+    }
+}
+
+/*
+ * Export a native array as a DLPack capsule.  `code` and `bits` are the
+ * DLPack dtype.  The NRT reference to the array's MemInfo is stolen.
+ */
+NUMBA_EXPORT_FUNC(PyObject *)
+NRT_adapt_ndarray_to_dlpack(arystruct_t *arystruct, int ndim, int code,
+                            int bits)
+{
+    DLManagedTensor *managed;
+    DLTensor *t;
+    int64_t *shape_and_strides;
+    npy_intp *shape = arystruct->shape_and_strides;
+    npy_intp *strides = shape + ndim;
+    PyObject *capsule;
+    int i;
+
+    for (i = 0; i < ndim; i++) {
+        if (strides[i] % arystruct->itemsize) {
+            PyErr_SetString(PyExc_BufferError,
+                            "DLPack requires strides to be a multiple of "
+                            "the item size");
+            goto error;
+        }
+    }
+    /* The shape and strides are stored right after the tensor */
+    managed = NRT_Allocate(sizeof(DLManagedTensor) +
+                           2 * ndim * sizeof(int64_t));
+    if (managed == NULL) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    shape_and_strides = (int64_t *) (managed + 1);
+    for (i = 0; i < ndim; i++) {
+        shape_and_strides[i] = shape[i];
+        shape_and_strides[ndim + i] = strides[i] / arystruct->itemsize;
+    }
+    t = &managed->dl_tensor;
+    t->data = arystruct->data;
+    t->device.device_type = NRT_DLPACK_CPU;
+    t->device.device_id = 0;
+    t->ndim = ndim;
+    t->dtype.code = (uint8_t) code;
+    t->dtype.bits = (uint8_t) bits;
+    t->dtype.lanes = 1;
+    t->shape = shape_and_strides;
+    t->strides = shape_and_strides + ndim;
+    t->byte_offset = 0;
+    managed->manager_ctx = arystruct->meminfo;
+    managed->deleter = dlpack_export_deleter;
+
+    capsule = PyCapsule_New(managed, "dltensor", dlpack_capsule_destructor);
+    if (capsule == NULL) {
+        NRT_Free(managed);
+        goto error;
+    }
+    if (arystruct->meminfo) {
+        /* The consumer may release the tensor from any thread */
+        NRT_MemInfo_share(arystruct->meminfo);
+    }
+    return capsule;
+
+error:
+    if (arystruct->meminfo)
+        NRT_MemInfo_release(arystruct->meminfo);
+    return NULL;
+}
+
+/*
+ * Arrow C Data Interface support
+ * (https://arrow.apache.org/docs/format/CDataInterface.html).
+ * The structures below are the ones from the specification; only
+ * non-nested arrays (primitive types and strings) are supported.
+ */
+
+struct ArrowSchema {
+    const char *format;
+    const char *name;
+    const char *metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema **children;
+    struct ArrowSchema *dictionary;
+    void (*release)(struct ArrowSchema *);
+    void *private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void **buffers;
+    struct ArrowArray **children;
+    struct ArrowArray *dictionary;
+    void (*release)(struct ArrowArray *);
+    void *private_data;
+};
+
+/* The native layout of an Arrow array, see ArrowArrayModel */
+typedef struct {
+    void     *meminfo;
+    PyObject *parent;
+    npy_intp length;
+    npy_intp offset;
+    npy_intp null_count;
+    const void *validity;
+    const void *values;
+    const void *offsets;     /* NULL unless a string array */
+} arrowstruct_t;
+
+static void
+arrow_dtor(void *ptr, size_t size, void *info) {
+    struct ArrowArray *array = ptr;
+    if (array->release)
+        array->release(array);
+    NRT_Free(array);
+}
+
+/*
+ * Call `obj.__arrow_c_array__()` and get the exported schema and array.
+ * On success, a new reference to the (schema, array) capsule pair is
+ * returned, which releases whatever wasn't moved out of it.
+ */
+static PyObject *
+arrow_export(PyObject *obj, struct ArrowSchema **schema,
+             struct ArrowArray **array) {
+    PyObject *res;
+
+    /* Reuse the capsules exported for typing, if any */
+    res = nrt_export_cache_take(arrow_export_cache, obj);
+    if (res == NULL)
+        res = PyObject_CallMethod(obj, "__arrow_c_array__", NULL);
+    if (res == NULL)
+        return NULL;
+    if (!PyTuple_Check(res) || PyTuple_GET_SIZE(res) != 2) {
+        PyErr_SetString(PyExc_TypeError,
+                        "__arrow_c_array__ must return a tuple of two "
+                        "capsules");
+        goto error;
+    }
+    *schema = PyCapsule_GetPointer(PyTuple_GET_ITEM(res, 0), "arrow_schema");
+    if (*schema == NULL)
+        goto error;
+    *array = PyCapsule_GetPointer(PyTuple_GET_ITEM(res, 1), "arrow_array");
+    if (*array == NULL)
+        goto error;
+    if ((*schema)->release == NULL || (*array)->release == NULL) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Arrow array was already released");
+        goto error;
+    }
+    return res;
+
+error:
+    Py_DECREF(res);
+    return NULL;
+}
+
+/*
+ * Adopt the array exported by `obj.__arrow_c_array__()`, whose format must
+ * be `format`.  The ArrowArray is moved out of its capsule and released
+ * with the returned MemInfo.
+ */
+NUMBA_EXPORT_FUNC(int)
+NRT_adapt_arrow_from_python(PyObject *obj, const char *format,
+                            arrowstruct_t *arrowstruct)
+{
+    PyObject *res;
+    struct ArrowSchema *schema;
+    struct ArrowArray *src, *array;
+    int64_t n_buffers;
+
+    res = arrow_export(obj, &schema, &src);
+    if (res == NULL)
+        return -1;
+    if (strcmp(schema->format, format) != 0 || schema->n_children != 0 ||
+        schema->dictionary != NULL) {
+        PyErr_Format(PyExc_TypeError,
+                     "expected Arrow array of format '%s', got '%s'",
+                     format, schema->format);
+        goto error;
+    }
+    /* Variable-size binary layouts have an offsets buffer */
+    n_buffers = (format[0] == 'u' || format[0] == 'U') ? 3 : 2;
+    if (src->n_buffers != n_buffers || src->n_children != 0) {
+        PyErr_SetString(PyExc_TypeError, "unexpected Arrow array layout");
+        goto error;
+    }
+    array = NRT_Allocate(sizeof(struct ArrowArray));
+    if (array == NULL) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    /* Move the array: the capsule doesn't release it anymore */
+    *array = *src;
+    src->release = NULL;
+    arrowstruct->meminfo = NRT_MemInfo_new(array, 0, arrow_dtor, NULL);
+    if (arrowstruct->meminfo == NULL) {
+        arrow_dtor(array, 0, NULL);
+        PyErr_NoMemory();
+        goto error;
+    }
+    arrowstruct->parent = obj;
+    arrowstruct->length = (npy_intp) array->length;
+    arrowstruct->offset = (npy_intp) array->offset;
+    arrowstruct->null_count = (npy_intp) array->null_count;
+    arrowstruct->validity = array->buffers[0];
+    if (n_buffers == 3) {
+        arrowstruct->offsets = array->buffers[1];
+        arrowstruct->values = array->buffers[2];
+    }
+    else {
+        arrowstruct->offsets = NULL;
+        arrowstruct->values = array->buffers[1];
+    }
+    Py_DECREF(res);
+
+    NRT_Debug(nrt_debug_print("NRT_adapt_arrow_from_python %p\n",
+                              arrowstruct->meminfo));
+    return 0;
+
+error:
+    Py_DECREF(res);
+    return -1;
+}
+
 /*
  * Array adaptor code
  */
@@ -252,6 +723,7 @@ NRT_adapt_ndarray_from_python(PyObject *obj, arystruct_t* arystruct) {
     void *data;
 
     if (!PyArray_Check(obj)) {
+        /* See NRT_adapt_array_from_python() for other array types */
         return -1;
     }
 
@@ -277,6 +749,22 @@ NRT_adapt_ndarray_from_python(PyObject *obj, arystruct_t* arystruct) {
     return 0;
 }
 
+/*
+ * Like NRT_adapt_ndarray_from_python(), also adopting the tensors exported
+ * through DLPack.  `ndim` and `itemsize` are those of the native array type
+ * (`itemsize` is 0 if unknown), as a DLPack exporter may export a different
+ * tensor than the one it was typed from.
+ */
+NUMBA_EXPORT_FUNC(int)
+NRT_adapt_array_from_python(PyObject *obj, int ndim, int itemsize,
+                            arystruct_t *arystruct)
+{
+    if (!PyArray_Check(obj)) {
+        return adapt_dlpack_from_python(obj, ndim, itemsize, arystruct);
+    }
+    return NRT_adapt_ndarray_from_python(obj, arystruct);
+}
+
 static
 PyObject* try_to_return_parent(arystruct_t *arystruct, int ndim,
                                PyArray_Descr *descr)
@@ -294,7 +782,8 @@ PyObject* try_to_return_parent(arystruct_t *arystruct, int ndim,
     if (PyArray_NDIM(array) != ndim)
         goto RETURN_ARRAY_COPY;
 
-    if (PyObject_RichCompareBool((PyObject *) PyArray_DESCR(array),
+    if (PyArray_DESCR(array) != descr &&
+        PyObject_RichCompareBool((PyObject *) PyArray_DESCR(array),
                                  (PyObject *) descr, Py_EQ) <= 0)
         goto RETURN_ARRAY_COPY;
 
@@ -314,13 +803,16 @@ RETURN_ARRAY_COPY:
     return NULL;
 }
 
+/*
+ * Box a native array.  `retty` is the array's Python type, NULL meaning
+ * np.ndarray.  The NRT reference to the array's MemInfo is stolen.
+ */
 NUMBA_EXPORT_FUNC(PyObject *)
 NRT_adapt_ndarray_to_python(arystruct_t* arystruct, PyTypeObject *retty, int ndim,
                             int writeable, PyArray_Descr *descr)
 {
     PyArrayObject *array;
     MemInfoObject *miobj = NULL;
-    PyObject *args;
     npy_intp *shape, *strides;
     int flags = 0;
 
@@ -348,23 +840,21 @@ NRT_adapt_ndarray_to_python(arystruct_t* arystruct, PyTypeObject *retty, int ndi
     }
 
     if (arystruct->meminfo) {
-        /* wrap into MemInfoObject */
-        miobj = PyObject_New(MemInfoObject, &MemInfoType);
-        args = PyTuple_New(1);
-        /* SETITEM steals reference */
-        PyTuple_SET_ITEM(args, 0, PyLong_FromVoidPtr(arystruct->meminfo));
-        NRT_Debug(nrt_debug_print("NRT_adapt_ndarray_to_python arystruct->meminfo=%p\n", arystruct->meminfo));
-        /*  Note: MemInfo_init() does not incref.  This function steals the
-         *        NRT reference.
+        /* Wrap into MemInfoObject.  This is what MemInfo_init() does,
+         * without going through an argument tuple.  This function steals
+         * the NRT reference.
          */
-        NRT_Debug(nrt_debug_print("NRT_adapt_ndarray_to_python created MemInfo=%p\n", miobj));
-        if (MemInfo_init(miobj, args, NULL)) {
-            NRT_Debug(nrt_debug_print("MemInfo_init returned 0.\n"));
+        miobj = PyObject_New(MemInfoObject, &MemInfoType);
+        if (miobj == NULL)
             return NULL;
-        }
-        Py_DECREF(args);
+        NRT_Debug(nrt_debug_print("NRT_adapt_ndarray_to_python arystruct->meminfo=%p\n", arystruct->meminfo));
+        miobj->meminfo = arystruct->meminfo;
+        /* The Python object may be released from any thread */
+        NRT_MemInfo_share(miobj->meminfo);
     }
 
+    if (retty == NULL)
+        retty = &PyArray_Type;
     shape = arystruct->shape_and_strides;
     strides = shape + ndim;
     Py_INCREF((PyObject *) descr);
@@ -372,8 +862,10 @@ NRT_adapt_ndarray_to_python(arystruct_t* arystruct, PyTypeObject *retty, int ndi
                                                    shape, strides, arystruct->data,
                                                    flags, (PyObject *) miobj);
 
-    if (array == NULL)
+    if (array == NULL) {
+        Py_XDECREF(miobj);
         return NULL;
+    }
 
     /* Set writable */
 #if NPY_API_VERSION >= 0x00000007
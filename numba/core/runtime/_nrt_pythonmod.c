@@ -45,6 +45,12 @@ memsys_set_atomic_cas(PyObject *self, PyObject *args) {
     Py_RETURN_NONE;
 }
 
+static PyObject *
+memsys_release_arena(PyObject *self, PyObject *args) {
+    NRT_MemSys_release_arena();
+    Py_RETURN_NONE;
+}
+
 static PyObject *
 memsys_get_stats_alloc(PyObject *self, PyObject *args) {
     return PyLong_FromSize_t(NRT_MemSys_get_stats_alloc());
@@ -65,6 +71,82 @@ memsys_get_stats_mi_free(PyObject *self, PyObject *args) {
     return PyLong_FromSize_t(NRT_MemSys_get_stats_mi_free());
 }
 
+static PyObject *
+memsys_get_stats_bytes(PyObject *self, PyObject *args) {
+    return PyLong_FromSize_t(NRT_MemSys_get_stats_bytes());
+}
+
+static PyObject *
+memsys_set_memory_limit(PyObject *self, PyObject *args) {
+    Py_ssize_t limit;
+    if (!PyArg_ParseTuple(args, "n", &limit)) {
+        return NULL;
+    }
+    if (limit < 0) {
+        PyErr_SetString(PyExc_ValueError, "memory limit must be >= 0");
+        return NULL;
+    }
+    NRT_MemSys_set_memory_limit(limit);
+    Py_RETURN_NONE;
+}
+
+/*
+ * The Python callables ever registered by memsys_set_soft_limit().  They
+ * are kept alive forever, as a thread not holding the GIL may still be
+ * about to call a callback after it has been replaced.
+ */
+static PyObject *soft_limit_callbacks = NULL;
+
+/*
+ * Call the soft limit callback.  This can run on any thread, with or
+ * without the GIL, and possibly with an exception set.
+ */
+static void
+soft_limit_trampoline(size_t live_bytes, void *arg) {
+    PyGILState_STATE gstate;
+    PyObject *type, *value, *traceback, *res;
+    PyObject *callback = (PyObject *) arg;
+
+    gstate = PyGILState_Ensure();
+    PyErr_Fetch(&type, &value, &traceback);
+    res = PyObject_CallFunction(callback, "n", (Py_ssize_t) live_bytes);
+    if (res == NULL)
+        PyErr_WriteUnraisable(callback);
+    Py_XDECREF(res);
+    PyErr_Restore(type, value, traceback);
+    PyGILState_Release(gstate);
+}
+
+static PyObject *
+memsys_set_soft_limit(PyObject *self, PyObject *args) {
+    Py_ssize_t threshold;
+    PyObject *callback;
+    int known;
+    if (!PyArg_ParseTuple(args, "nO", &threshold, &callback)) {
+        return NULL;
+    }
+    if (callback != Py_None && !PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "callback must be callable or None");
+        return NULL;
+    }
+    if (callback == Py_None) {
+        NRT_MemSys_set_soft_limit(0, NULL, NULL);
+        Py_RETURN_NONE;
+    }
+    if (soft_limit_callbacks == NULL) {
+        soft_limit_callbacks = PyList_New(0);
+        if (soft_limit_callbacks == NULL)
+            return NULL;
+    }
+    known = PySequence_Contains(soft_limit_callbacks, callback);
+    if (known < 0)
+        return NULL;
+    if (!known && PyList_Append(soft_limit_callbacks, callback))
+        return NULL;
+    NRT_MemSys_set_soft_limit(threshold, soft_limit_trampoline, callback);
+    Py_RETURN_NONE;
+}
+
 
 /*
  * Create a new MemInfo with a owner PyObject
@@ -96,6 +178,8 @@ meminfo_alloc(PyObject *self, PyObject *args) {
         return NULL;
     }
     mi = NRT_MemInfo_alloc(size);
+    if (mi == NULL)
+        return PyErr_NoMemory();
     return PyLong_FromVoidPtr(mi);
 }
 
@@ -111,9 +195,112 @@ meminfo_alloc_safe(PyObject *self, PyObject *args) {
         return NULL;
     }
     mi = NRT_MemInfo_alloc_safe(size);
+    if (mi == NULL)
+        return PyErr_NoMemory();
     return PyLong_FromVoidPtr(mi);
 }
 
+/*
+ * Describe the tensor exported by `obj.__dlpack__()` as a
+ * (code, bits, shape, strides) tuple, strides being in items or None for
+ * a C-contiguous tensor.  Returns None if `obj` doesn't export a
+ * supported tensor.  Used for typing; if `keep` is true, the capsule is
+ * kept for unboxing `obj` in the same call.
+ */
+static PyObject *
+dlpack_describe(PyObject *self, PyObject *args) {
+    PyObject *obj, *capsule, *shape = NULL, *strides = NULL, *res = NULL;
+    DLManagedTensor *managed;
+    DLTensor *t;
+    int i, keep = 0;
+
+    if (!PyArg_ParseTuple(args, "O|i", &obj, &keep)) {
+        return NULL;
+    }
+    capsule = nrt_export_cache_take(dlpack_export_cache, obj);
+    if (capsule == NULL)
+        capsule = PyObject_CallMethod(obj, "__dlpack__", NULL);
+    if (capsule == NULL) {
+        PyErr_Clear();
+        Py_RETURN_NONE;
+    }
+    managed = dlpack_capsule_tensor(capsule);
+    if (managed == NULL) {
+        /* The capsule destructor releases the tensor */
+        Py_DECREF(capsule);
+        Py_RETURN_NONE;
+    }
+    t = &managed->dl_tensor;
+    shape = PyTuple_New(t->ndim);
+    if (shape == NULL)
+        goto error;
+    for (i = 0; i < t->ndim; i++) {
+        PyObject *dim = PyLong_FromLongLong(t->shape[i]);
+        if (dim == NULL)
+            goto error;
+        PyTuple_SET_ITEM(shape, i, dim);
+    }
+    if (t->strides) {
+        strides = PyTuple_New(t->ndim);
+        if (strides == NULL)
+            goto error;
+        for (i = 0; i < t->ndim; i++) {
+            PyObject *stride = PyLong_FromLongLong(t->strides[i]);
+            if (stride == NULL)
+                goto error;
+            PyTuple_SET_ITEM(strides, i, stride);
+        }
+    }
+    else {
+        Py_INCREF(Py_None);
+        strides = Py_None;
+    }
+    res = Py_BuildValue("iiOO", t->dtype.code, t->dtype.bits, shape, strides);
+    if (res != NULL && keep &&
+        nrt_export_cache_put(&dlpack_export_cache, obj, capsule)) {
+        Py_CLEAR(res);
+    }
+error:
+    Py_XDECREF(shape);
+    Py_XDECREF(strides);
+    Py_DECREF(capsule);
+    return res;
+}
+
+/*
+ * Get the format string of the array exported by
+ * `obj.__arrow_c_array__()`, or None if it isn't a non-nested array.
+ * Used for typing; if `keep` is true, the exported capsules are kept for
+ * unboxing `obj` in the same call.
+ */
+static PyObject *
+arrow_describe(PyObject *self, PyObject *args) {
+    PyObject *obj, *res, *format;
+    struct ArrowSchema *schema;
+    struct ArrowArray *array;
+    int keep = 0;
+
+    if (!PyArg_ParseTuple(args, "O|i", &obj, &keep)) {
+        return NULL;
+    }
+    res = arrow_export(obj, &schema, &array);
+    if (res == NULL) {
+        PyErr_Clear();
+        Py_RETURN_NONE;
+    }
+    if (schema->n_children != 0 || schema->dictionary != NULL) {
+        Py_DECREF(res);
+        Py_RETURN_NONE;
+    }
+    format = PyUnicode_FromString(schema->format);
+    if (format != NULL && keep &&
+        nrt_export_cache_put(&arrow_export_cache, obj, res)) {
+        Py_CLEAR(format);
+    }
+    Py_DECREF(res);
+    return format;
+}
+
 static PyMethodDef ext_methods[] = {
 #define declmethod(func) { #func , ( PyCFunction )func , METH_VARARGS , NULL }
 #define declmethod_noargs(func) { #func , ( PyCFunction )func , METH_NOARGS, NULL }
@@ -121,13 +308,19 @@ static PyMethodDef ext_methods[] = {
     declmethod_noargs(memsys_shutdown),
     declmethod(memsys_set_atomic_inc_dec),
     declmethod(memsys_set_atomic_cas),
+    declmethod_noargs(memsys_release_arena),
     declmethod_noargs(memsys_get_stats_alloc),
     declmethod_noargs(memsys_get_stats_free),
     declmethod_noargs(memsys_get_stats_mi_alloc),
     declmethod_noargs(memsys_get_stats_mi_free),
+    declmethod_noargs(memsys_get_stats_bytes),
+    declmethod(memsys_set_memory_limit),
+    declmethod(memsys_set_soft_limit),
     declmethod(meminfo_new),
     declmethod(meminfo_alloc),
     declmethod(meminfo_alloc_safe),
+    declmethod(dlpack_describe),
+    declmethod(arrow_describe),
     { NULL },
 #undef declmethod
 };
@@ -154,8 +347,12 @@ build_c_helpers_dict(void)
 #define declmethod(func) _declpointer(#func, &NRT_##func)
 
 declmethod(adapt_ndarray_from_python);
+declmethod(adapt_array_from_python);
 declmethod(adapt_ndarray_to_python);
 declmethod(adapt_buffer_from_python);
+declmethod(adapt_ndarray_to_dlpack);
+declmethod(adapt_arrow_from_python);
+declmethod(clear_export_caches);
 declmethod(meminfo_new_from_pyobject);
 declmethod(meminfo_as_pyobject);
 declmethod(meminfo_from_pyobject);
@@ -164,6 +361,7 @@ declmethod(MemInfo_alloc_safe);
 declmethod(MemInfo_alloc_aligned);
 declmethod(MemInfo_alloc_safe_aligned);
 declmethod(MemInfo_alloc_safe_aligned_external);
+declmethod(MemInfo_alloc_safe_aligned_arena);
 declmethod(MemInfo_alloc_dtor_safe);
 declmethod(MemInfo_call_dtor);
 declmethod(MemInfo_new_varsize);
@@ -172,7 +370,11 @@ declmethod(MemInfo_varsize_alloc);
 declmethod(MemInfo_data);
 declmethod(MemInfo_varsize_free);
 declmethod(MemInfo_varsize_realloc);
+declmethod(MemInfo_new_mmap);
+declmethod(MemInfo_mmap_flush);
+declmethod(MemInfo_acquire);
 declmethod(MemInfo_release);
+declmethod(MemSys_park_thread);
 declmethod(Allocate);
 declmethod(Free);
 declmethod(get_api);
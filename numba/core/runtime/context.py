@@ -72,14 +72,20 @@ class NRTContext(object):
         a Python int or a LLVM uint32 value.
 
         A pointer to the MemInfo is returned.
+
+        If the target context has arena allocation enabled, the MemInfo is
+        served from the calling thread's NRT arena.
         """
         self._require_nrt()
 
         mod = builder.module
         u32 = ir.IntType(32)
         fnty = ir.FunctionType(cgutils.voidptr_t, [cgutils.intp_t, u32])
-        fn = mod.get_or_insert_function(fnty,
-                                        name="NRT_MemInfo_alloc_safe_aligned")
+        if self._context.enable_nrt_arena:
+            fname = "NRT_MemInfo_alloc_safe_aligned_arena"
+        else:
+            fname = "NRT_MemInfo_alloc_safe_aligned"
+        fn = mod.get_or_insert_function(fnty, name=fname)
         fn.return_value.add_attribute("noalias")
         if isinstance(align, int):
             align = self._context.get_constant(types.uint32, align)
@@ -162,6 +168,56 @@ class NRTContext(object):
         fn.return_value.add_attribute("noalias")
         return builder.call(fn, [meminfo, size])
 
+    def meminfo_new_mmap(self, builder, path, pathlen, offset, size_ptr,
+                         mode):
+        """
+        Map a file into a new MemInfo.  `path` points to `pathlen` bytes
+        of file name, `size_ptr` to the number of bytes to map (-1 maps up
+        to the end of the file, and is updated with the mapped size).  `mode`
+        is one of the NRT_MMAP_* modes as a Python int.
+
+        A pointer to the MemInfo is returned, NULL on error.
+        """
+        self._require_nrt()
+
+        mod = builder.module
+        i32 = ir.IntType(32)
+        fnty = ir.FunctionType(cgutils.voidptr_t,
+                               [cgutils.voidptr_t, cgutils.intp_t,
+                                cgutils.intp_t, cgutils.intp_t.as_pointer(),
+                                i32])
+        fn = mod.get_or_insert_function(fnty, name="NRT_MemInfo_new_mmap")
+        fn.return_value.add_attribute("noalias")
+        return builder.call(fn, [path, pathlen, offset, size_ptr,
+                                 i32(mode)])
+
+    def meminfo_mmap_flush(self, builder, meminfo, sync):
+        """
+        Write back the file mapping of a MemInfo created by
+        meminfo_new_mmap().  `sync` is a LLVM boolean.  Returns a int32
+        status: 0 on success, -1 on error, 1 if the MemInfo doesn't map
+        a file.
+        """
+        self._require_nrt()
+
+        mod = builder.module
+        i32 = ir.IntType(32)
+        fnty = ir.FunctionType(i32, [cgutils.voidptr_t, i32])
+        fn = mod.get_or_insert_function(fnty, name="NRT_MemInfo_mmap_flush")
+        return builder.call(fn, [meminfo, builder.zext(sync, i32)])
+
+    def park_thread(self, builder):
+        """
+        Park the calling thread's NRT state until its next use of the NRT,
+        so that other threads can merge the MemInfos it owns meanwhile.
+        """
+        self._require_nrt()
+
+        mod = builder.module
+        fnty = ir.FunctionType(ir.VoidType(), ())
+        fn = mod.get_or_insert_function(fnty, name="NRT_MemSys_park_thread")
+        return builder.call(fn, ())
+
     def meminfo_data(self, builder, meminfo):
         """
         Given a MemInfo pointer, return a pointer to the allocated data
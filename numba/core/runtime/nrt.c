@@ -1,8 +1,27 @@
 #include <stdarg.h>
+#include <stddef.h> /* for ptrdiff_t */
 #include <string.h> /* for memset */
 #include "nrt.h"
 #include "assert.h"
 
+#ifdef _MSC_VER
+#include <windows.h>
+#define THREAD_LOCAL(ty) __declspec(thread) ty
+#else
+#include <pthread.h>
+/* Non-standard C99 extension that's understood by gcc and clang */
+#define THREAD_LOCAL(ty) __thread ty
+#endif
+
+#if !defined(_MSC_VER)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NRT_HAVE_MMAP 1
+#endif
+
 #if !defined MIN
 #define MIN(a, b) ((a) < (b)) ? (a) : (b)
 #endif
@@ -11,8 +30,27 @@
 typedef int (*atomic_meminfo_cas_func)(void **ptr, void *cmp,
                                        void *repl, void **oldptr);
 
+typedef struct ThreadState NRT_ThreadState;
 
-/* NOTE: if changing the layout, please update numba.core.runtime.atomicops */
+/*
+ * MemInfo reference counts are biased towards the thread that created the
+ * MemInfo (its owner):
+ *
+ * - `local_refct` is only ever touched by the owner, without atomics.
+ * - `refct` is the shared count, updated atomically by all other threads.
+ *   It is a signed count stored in the upper bits, with the NRT_REFCT_MERGED
+ *   and NRT_REFCT_QUEUED flags in the low bits.
+ *
+ * The references are the sum of both counts.  When the owner releases its
+ * last local reference the local count is merged into the shared one and
+ * the MemInfo is treated as shared from then on.  If another thread drops
+ * the shared count below zero before that happens, it cannot tell whether
+ * the MemInfo is dead, so the MemInfo is queued to its owner for merging.
+ * While the owner is parked (between two calls into compiled code), that
+ * thread merges the MemInfo itself instead.
+ *
+ * NOTE: if changing the layout, please update numba.core.runtime.nrtdynmod
+ */
 struct MemInfo {
     size_t            refct;
     NRT_dtor_function dtor;
@@ -20,8 +58,39 @@ struct MemInfo {
     void              *data;
     size_t            size;    /* only used for NRT allocated memory */
     NRT_ExternalAllocator *external_allocator;
+    NRT_ThreadState   *owner;
+    size_t            local_refct;  /* 0 once merged */
+    NRT_MemInfo       *merge_next;  /* link in the owner's merge queue */
+};
+
+#define NRT_REFCT_MERGED ((size_t) 1)
+#define NRT_REFCT_QUEUED ((size_t) 2)
+#define NRT_REFCT_ONE    ((size_t) 4)
+#define NRT_REFCT_COUNT(refct) \
+    ((ptrdiff_t) ((refct) & ~(NRT_REFCT_ONE - 1)) / (ptrdiff_t) NRT_REFCT_ONE)
+
+/*
+ * Per-thread state.  MemInfos may outlive their owner, so it is freed once
+ * the thread has exited and none of its MemInfos is left unmerged or queued.
+ */
+struct ThreadState {
+    /* Stack of MemInfos waiting to be merged, NRT_THREAD_PARKED while the
+       thread is parked and NRT_THREAD_DEAD once it has exited */
+    NRT_MemInfo *merge_queue;
+    /* References from the MemInfos released by the thread itself, updated
+       without atomics */
+    size_t local_refs;
+    /* References from the MemInfos released by other threads (only once
+       the thread has exited), biased by NRT_THREAD_ALIVE until then */
+    size_t shared_refs;
 };
 
+#define NRT_THREAD_DEAD ((NRT_MemInfo *) 1)
+#define NRT_THREAD_PARKED ((NRT_MemInfo *) 2)
+/* Parked, with another thread merging a MemInfo on its behalf */
+#define NRT_THREAD_STEALING ((NRT_MemInfo *) 3)
+#define NRT_THREAD_ALIVE ((size_t) 1 << (sizeof(size_t) * 8 - 2))
+
 
 /*
  * Misc helpers.
@@ -51,6 +120,14 @@ struct MemSys {
     int shutting;
     /* Stats */
     size_t stats_alloc, stats_free, stats_mi_alloc, stats_mi_free;
+    /* Bytes managed by live MemInfos */
+    size_t stats_bytes;
+    /* Allocations making stats_bytes exceed the limit fail, 0 if unlimited */
+    size_t mem_limit;
+    /* Callback run when stats_bytes crosses the soft limit */
+    size_t mem_soft_limit;
+    NRT_soft_limit_func soft_limit_func;
+    void *soft_limit_arg;
     /* System allocation functions */
     struct {
         NRT_malloc_func malloc;
@@ -63,12 +140,41 @@ struct MemSys {
 static NRT_MemSys TheMSys;
 
 
+static void nrt_thread_exit(void *state);
+
+#ifdef _MSC_VER
+static DWORD nrt_thread_key = FLS_OUT_OF_INDEXES;
+
+static VOID WINAPI nrt_thread_exit_callback(PVOID state) {
+    if (state)
+        nrt_thread_exit(state);
+}
+#else
+static pthread_key_t nrt_thread_key;
+static pthread_once_t nrt_thread_key_once = PTHREAD_ONCE_INIT;
+
+static void nrt_thread_key_init(void) {
+    if (pthread_key_create(&nrt_thread_key, nrt_thread_exit))
+        nrt_fatal_error("cannot create NRT thread key");
+}
+#endif
+
 void NRT_MemSys_init(void) {
     memset(&TheMSys, 0, sizeof(NRT_MemSys));
     /* Bind to libc allocator */
     TheMSys.allocator.malloc = malloc;
     TheMSys.allocator.realloc = realloc;
     TheMSys.allocator.free = free;
+    /* Register the hook merging the MemInfos queued to exiting threads */
+#ifdef _MSC_VER
+    if (nrt_thread_key == FLS_OUT_OF_INDEXES) {
+        nrt_thread_key = FlsAlloc(nrt_thread_exit_callback);
+        if (nrt_thread_key == FLS_OUT_OF_INDEXES)
+            nrt_fatal_error("cannot create NRT thread key");
+    }
+#else
+    pthread_once(&nrt_thread_key_once, nrt_thread_key_init);
+#endif
 }
 
 void NRT_MemSys_shutdown(void) {
@@ -124,6 +230,67 @@ size_t NRT_MemSys_get_stats_mi_free() {
     return TheMSys.stats_mi_free;
 }
 
+size_t NRT_MemSys_get_stats_bytes() {
+    return TheMSys.stats_bytes;
+}
+
+void NRT_MemSys_set_memory_limit(size_t limit) {
+    TheMSys.mem_limit = limit;
+}
+
+void NRT_MemSys_set_soft_limit(size_t threshold, NRT_soft_limit_func func,
+                               void *arg)
+{
+    /* Disable first so a concurrent allocation never sees a mismatch */
+    TheMSys.soft_limit_func = NULL;
+    TheMSys.mem_soft_limit = threshold;
+    TheMSys.soft_limit_arg = arg;
+    TheMSys.soft_limit_func = func;
+}
+
+/* Atomically add `delta` to `*ptr`, returning the new value */
+static
+size_t nrt_atomic_add(size_t *ptr, size_t delta) {
+    void *old = (void *) *ptr;
+    void *new;
+    do {
+        new = (void *) ((size_t) old + delta);
+    } while (!TheMSys.atomic_cas((void **) ptr, old, new, &old));
+    return (size_t) new;
+}
+
+/*
+ * Whether allocating `size` more bytes would exceed the memory limit.
+ * The check is not atomic with the allocation, so concurrent allocations
+ * may overshoot the limit by their own size.
+ */
+static
+int nrt_over_memory_limit(size_t size) {
+    size_t limit = TheMSys.mem_limit;
+    size_t live = TheMSys.stats_bytes;
+    if (limit == 0)
+        return 0;
+    if (size > limit || live > limit - size) {
+        NRT_Debug(nrt_debug_print("nrt_over_memory_limit size=%zu live=%zu\n",
+                                  size, live));
+        return 1;
+    }
+    return 0;
+}
+
+/* Account for `delta` more (or less) bytes managed by MemInfos */
+static
+void nrt_update_stats_bytes(size_t delta) {
+    size_t live = nrt_atomic_add(&TheMSys.stats_bytes, delta);
+    NRT_soft_limit_func func = TheMSys.soft_limit_func;
+    size_t threshold = TheMSys.mem_soft_limit;
+    /* Only notify when growing past the threshold */
+    if (func != NULL && live > threshold && live - delta <= threshold &&
+        (ptrdiff_t) delta > 0) {
+        func(live, TheMSys.soft_limit_arg);
+    }
+}
+
 static
 size_t nrt_testing_atomic_inc(size_t *ptr){
     /* non atomic */
@@ -166,15 +333,263 @@ void NRT_MemSys_set_atomic_cas_stub(void) {
 }
 
 
+/*
+ * Thread ownership of MemInfos.
+ */
+
+static THREAD_LOCAL(NRT_ThreadState *) nrt_thread_state;
+
+static void nrt_thread_unpark(NRT_ThreadState *state);
+
+/* Whether the thread is parked.  Only meaningful when called by the owner,
+   as only the owner parks its state. */
+static
+int nrt_thread_parked(NRT_ThreadState *state) {
+    NRT_MemInfo *head = state->merge_queue;
+    return head == NRT_THREAD_PARKED || head == NRT_THREAD_STEALING;
+}
+
+/* The calling thread's state, if any, unparked so that it can touch the
+   local refcounts */
+static
+NRT_ThreadState *nrt_thread_state_active(void) {
+    NRT_ThreadState *state = nrt_thread_state;
+    if (state != NULL && nrt_thread_parked(state))
+        nrt_thread_unpark(state);
+    return state;
+}
+
+static
+NRT_ThreadState *nrt_thread_state_get(void) {
+    NRT_ThreadState *state = nrt_thread_state_active();
+    if (state != NULL)
+        return state;
+    /* Not from the NRT allocator, which may change while it is alive */
+    state = malloc(sizeof(NRT_ThreadState));
+    if (state == NULL)
+        nrt_fatal_error("cannot allocate NRT thread state");
+    state->merge_queue = NULL;
+    state->local_refs = 0;
+    state->shared_refs = NRT_THREAD_ALIVE;
+#ifdef _MSC_VER
+    FlsSetValue(nrt_thread_key, state);
+#else
+    pthread_setspecific(nrt_thread_key, state);
+#endif
+    nrt_thread_state = state;
+    return state;
+}
+
+/* Atomically add `delta` to the shared refcount, returning the new value */
+static
+size_t nrt_refct_add(NRT_MemInfo *mi, size_t delta) {
+    return nrt_atomic_add(&mi->refct, delta);
+}
+
+/*
+ * Drop the reference of a MemInfo to its owner's state, once the MemInfo is
+ * merged and not queued (so that no thread can push it to the state's merge
+ * queue any more).
+ */
+static
+void nrt_thread_state_release(NRT_ThreadState *state) {
+    if (state == nrt_thread_state) {
+        state->local_refs--;
+    } else if (nrt_atomic_add(&state->shared_refs, (size_t) -1) == 0) {
+        NRT_Debug(nrt_debug_print("nrt_thread_state free %p\n", state));
+        free(state);
+    }
+}
+
+/*
+ * Merge the local refcount into the shared one.  Must be called by the owner
+ * or, once the owner has exited, by the thread that queued the MemInfo.
+ * Returns the new shared refcount.
+ */
+static
+size_t nrt_refct_merge(NRT_MemInfo *mi) {
+    NRT_ThreadState *owner = mi->owner;
+    size_t delta = mi->local_refct * NRT_REFCT_ONE + NRT_REFCT_MERGED;
+    size_t refct;
+    NRT_Debug(nrt_debug_print("nrt_refct_merge %p local_refct=%zu\n", mi,
+                              mi->local_refct));
+    mi->local_refct = 0;
+    refct = nrt_refct_add(mi, delta);
+    /* If queued, the owner's state is released when taken off the queue */
+    if (!(refct & NRT_REFCT_QUEUED))
+        nrt_thread_state_release(owner);
+    return refct;
+}
+
+/*
+ * Merge a MemInfo taken off a merge queue and clear its queued flag.
+ * Returns whether the MemInfo is dead.
+ */
+static
+int nrt_refct_unqueue_merge(NRT_MemInfo *mi) {
+    NRT_ThreadState *owner = mi->owner;
+    size_t delta = (size_t) 0 - NRT_REFCT_QUEUED;
+    size_t refct;
+    if (mi->local_refct > 0) {
+        /* Not merged yet */
+        delta += mi->local_refct * NRT_REFCT_ONE + NRT_REFCT_MERGED;
+        mi->local_refct = 0;
+    }
+    refct = nrt_refct_add(mi, delta);
+    nrt_thread_state_release(owner);
+    return refct == NRT_REFCT_MERGED;
+}
+
+static
+void nrt_refct_unqueue(NRT_MemInfo *mi) {
+    if (nrt_refct_unqueue_merge(mi)) {
+        NRT_MemInfo_call_dtor(mi);
+    }
+}
+
+/* Whether MemInfos are waiting in the merge queue of a running thread */
+static
+int nrt_merge_queue_pending(NRT_ThreadState *state) {
+    NRT_MemInfo *head = state->merge_queue;
+    return head != NULL && head != NRT_THREAD_DEAD;
+}
+
+static
+void nrt_merge_queue_drain(NRT_ThreadState *state, NRT_MemInfo *replacement) {
+    void *head = (void *) state->merge_queue;
+    NRT_MemInfo *mi, *next;
+    while (!TheMSys.atomic_cas((void **) &state->merge_queue, head,
+                               replacement, &head))
+        ;
+    for (mi = head; mi != NULL; mi = next) {
+        next = mi->merge_next;
+        nrt_refct_unqueue(mi);
+    }
+}
+
+static
+void nrt_merge_queue_push(NRT_MemInfo *mi) {
+    NRT_ThreadState *state = mi->owner;
+    void *head, *old;
+    int dead;
+    /* An acquire load, so that seeing the owner dead or parked orders its
+       last updates of the local count before ours */
+    TheMSys.atomic_cas((void **) &state->merge_queue, NULL, NULL, &head);
+    for (;;) {
+        if (head == NRT_THREAD_DEAD) {
+            /* The owner is gone, nobody else can touch the local count */
+            nrt_refct_unqueue(mi);
+            return;
+        }
+        if (head == NRT_THREAD_STEALING) {
+            /* Wait for the other thread to hand the owner's state back */
+            TheMSys.atomic_cas((void **) &state->merge_queue, NULL, NULL,
+                               &head);
+            continue;
+        }
+        if (head == NRT_THREAD_PARKED) {
+            /* The owner cannot touch the local count until we are done */
+            if (!TheMSys.atomic_cas((void **) &state->merge_queue, head,
+                                    NRT_THREAD_STEALING, &head))
+                continue;
+            dead = nrt_refct_unqueue_merge(mi);
+            TheMSys.atomic_cas((void **) &state->merge_queue,
+                               NRT_THREAD_STEALING, NRT_THREAD_PARKED, &old);
+            /* Out of the critical section, as it may release more MemInfos
+               of the same owner */
+            if (dead)
+                NRT_MemInfo_call_dtor(mi);
+            return;
+        }
+        mi->merge_next = head;
+        if (TheMSys.atomic_cas((void **) &state->merge_queue, head, mi, &head))
+            return;
+    }
+}
+
+static
+void nrt_thread_unpark(NRT_ThreadState *state) {
+    void *head;
+    NRT_Debug(nrt_debug_print("nrt_thread_unpark %p\n", state));
+    /* Spins while another thread merges a MemInfo on our behalf */
+    while (!TheMSys.atomic_cas((void **) &state->merge_queue,
+                               NRT_THREAD_PARKED, NULL, &head))
+        ;
+}
+
+void NRT_MemSys_park_thread(void) {
+    NRT_ThreadState *state = nrt_thread_state;
+    void *head;
+    if (state == NULL || nrt_thread_parked(state))
+        return;
+    NRT_Debug(nrt_debug_print("NRT_MemSys_park_thread %p\n", state));
+    /* Only park with an empty queue, as the destructors run by draining it
+       may use the NRT again */
+    while (!TheMSys.atomic_cas((void **) &state->merge_queue, NULL,
+                               NRT_THREAD_PARKED, &head)) {
+        nrt_merge_queue_drain(state, NULL);
+    }
+}
+
+/* Whether the calling thread owns the MemInfo and it is not merged yet */
+static
+int nrt_is_owner(NRT_ThreadState *state, NRT_MemInfo *mi) {
+    return state != NULL && mi->owner == state && mi->local_refct > 0;
+}
+
+static
+void nrt_thread_exit(void *arg) {
+    NRT_ThreadState *state = arg;
+    NRT_Debug(nrt_debug_print("nrt_thread_exit %p\n", state));
+    if (TheMSys.atomic_cas == NULL) {
+        /* The NRT was never initialized, there cannot be any MemInfo */
+        free(state);
+        return;
+    }
+    if (nrt_thread_parked(state))
+        nrt_thread_unpark(state);
+    /* Merged as the owner, as are MemInfos released by the destructors */
+    nrt_merge_queue_drain(state, NRT_THREAD_DEAD);
+    /* The current arena chunk would otherwise never be freed */
+    NRT_MemSys_release_arena();
+    /* Any later use of the NRT on this thread gets a fresh state */
+    nrt_thread_state = NULL;
+    /* Hand over the references of the MemInfos still alive to the
+       threads which will release them */
+    if (nrt_atomic_add(&state->shared_refs,
+                       state->local_refs - NRT_THREAD_ALIVE) == 0) {
+        NRT_Debug(nrt_debug_print("nrt_thread_state free %p\n", state));
+        free(state);
+    }
+}
+
+
 /*
  * The MemInfo structure.
  */
 
+/* Defined with the arena allocation API below */
+static NRT_ExternalAllocator nrt_arena_allocator;
+
+/* The arena accounts for its chunks instead of the MemInfos it serves */
+static
+int nrt_is_arena_allocator(NRT_ExternalAllocator *allocator) {
+    return allocator == &nrt_arena_allocator;
+}
+
 void NRT_MemInfo_init(NRT_MemInfo *mi,void *data, size_t size,
                       NRT_dtor_function dtor, void *dtor_info,
                       NRT_ExternalAllocator *external_allocator)
 {
-    mi->refct = 1;  /* starts with 1 refct */
+    NRT_ThreadState *state = nrt_thread_state_get();
+    mi->refct = 0;
+    mi->local_refct = 1;  /* starts with 1 refct, owned by this thread */
+    mi->owner = state;
+    mi->merge_next = NULL;
+    state->local_refs++;
+    if (nrt_merge_queue_pending(state)) {
+        nrt_merge_queue_drain(state, NULL);
+    }
     mi->dtor = dtor;
     mi->dtor_info = dtor_info;
     mi->data = data;
@@ -183,6 +598,8 @@ void NRT_MemInfo_init(NRT_MemInfo *mi,void *data, size_t size,
     NRT_Debug(nrt_debug_print("NRT_MemInfo_init mi=%p external_allocator=%p\n", mi, external_allocator));
     /* Update stats */
     TheMSys.atomic_inc(&TheMSys.stats_mi_alloc);
+    if (size && !nrt_is_arena_allocator(external_allocator))
+        nrt_update_stats_bytes(size);
 }
 
 NRT_MemInfo *NRT_MemInfo_new(void *data, size_t size,
@@ -190,6 +607,8 @@ NRT_MemInfo *NRT_MemInfo_new(void *data, size_t size,
 {
     NRT_MemInfo *mi = NRT_Allocate(sizeof(NRT_MemInfo));
     NRT_Debug(nrt_debug_print("NRT_MemInfo_new mi=%p\n", mi));
+    if (mi == NULL)
+        return NULL;
     NRT_MemInfo_init(mi, data, size, dtor, dtor_info, NULL);
     return mi;
 }
@@ -197,7 +616,7 @@ NRT_MemInfo *NRT_MemInfo_new(void *data, size_t size,
 size_t NRT_MemInfo_refcount(NRT_MemInfo *mi) {
     /* Should never returns 0 for a valid MemInfo */
     if (mi && mi->data)
-        return mi->refct;
+        return NRT_REFCT_COUNT(mi->refct) + mi->local_refct;
     else{
         return (size_t)-1;
     }
@@ -210,11 +629,20 @@ void nrt_internal_dtor_safe(void *ptr, size_t size, void *info) {
     memset(ptr, 0xDE, MIN(size, 256));
 }
 
+/*
+ * Returns NULL if the memory limit is exceeded or the allocation fails.
+ */
 static
 void *nrt_allocate_meminfo_and_data(size_t size, NRT_MemInfo **mi_out, NRT_ExternalAllocator *allocator) {
     NRT_MemInfo *mi;
+    char *base;
     NRT_Debug(nrt_debug_print("nrt_allocate_meminfo_and_data %p\n", allocator));
-    char *base = NRT_Allocate_External(sizeof(NRT_MemInfo) + size, allocator);
+    /* Arena chunks are checked against the limit as they are allocated */
+    if (!nrt_is_arena_allocator(allocator) && nrt_over_memory_limit(size))
+        return NULL;
+    base = NRT_Allocate_External(sizeof(NRT_MemInfo) + size, allocator);
+    if (base == NULL)
+        return NULL;
     mi = (NRT_MemInfo *) base;
     *mi_out = mi;
     return base + sizeof(NRT_MemInfo);
@@ -237,6 +665,8 @@ void nrt_internal_custom_dtor_safe(void *ptr, size_t size, void *info) {
 NRT_MemInfo *NRT_MemInfo_alloc(size_t size) {
     NRT_MemInfo *mi;
     void *data = nrt_allocate_meminfo_and_data(size, &mi, NULL);
+    if (data == NULL)
+        return NULL;
     NRT_Debug(nrt_debug_print("NRT_MemInfo_alloc %p\n", data));
     NRT_MemInfo_init(mi, data, size, NULL, NULL, NULL);
     return mi;
@@ -245,6 +675,8 @@ NRT_MemInfo *NRT_MemInfo_alloc(size_t size) {
 NRT_MemInfo *NRT_MemInfo_alloc_external(size_t size, NRT_ExternalAllocator *allocator) {
     NRT_MemInfo *mi;
     void *data = nrt_allocate_meminfo_and_data(size, &mi, allocator);
+    if (data == NULL)
+        return NULL;
     NRT_Debug(nrt_debug_print("NRT_MemInfo_alloc %p\n", data));
     NRT_MemInfo_init(mi, data, size, NULL, NULL, allocator);
     return mi;
@@ -257,6 +689,8 @@ NRT_MemInfo *NRT_MemInfo_alloc_safe(size_t size) {
 NRT_MemInfo* NRT_MemInfo_alloc_dtor_safe(size_t size, NRT_dtor_function dtor) {
     NRT_MemInfo *mi;
     void *data = nrt_allocate_meminfo_and_data(size, &mi, NULL);
+    if (data == NULL)
+        return NULL;
     /* Only fill up a couple cachelines with debug markers, to minimize
        overhead. */
     memset(data, 0xCB, MIN(size, 256));
@@ -273,6 +707,8 @@ void *nrt_allocate_meminfo_and_data_align(size_t size, unsigned align,
     size_t offset, intptr, remainder;
     NRT_Debug(nrt_debug_print("nrt_allocate_meminfo_and_data_align %p\n", allocator));
     char *base = nrt_allocate_meminfo_and_data(size + 2 * align, mi, allocator);
+    if (base == NULL)
+        return NULL;
     intptr = (size_t) base;
     /* See if we are aligned */
     remainder = intptr % align;
@@ -287,6 +723,8 @@ void *nrt_allocate_meminfo_and_data_align(size_t size, unsigned align,
 NRT_MemInfo *NRT_MemInfo_alloc_aligned(size_t size, unsigned align) {
     NRT_MemInfo *mi;
     void *data = nrt_allocate_meminfo_and_data_align(size, align, &mi, NULL);
+    if (data == NULL)
+        return NULL;
     NRT_Debug(nrt_debug_print("NRT_MemInfo_alloc_aligned %p\n", data));
     NRT_MemInfo_init(mi, data, size, NULL, NULL, NULL);
     return mi;
@@ -295,6 +733,8 @@ NRT_MemInfo *NRT_MemInfo_alloc_aligned(size_t size, unsigned align) {
 NRT_MemInfo *NRT_MemInfo_alloc_safe_aligned(size_t size, unsigned align) {
     NRT_MemInfo *mi;
     void *data = nrt_allocate_meminfo_and_data_align(size, align, &mi, NULL);
+    if (data == NULL)
+        return NULL;
     /* Only fill up a couple cachelines with debug markers, to minimize
        overhead. */
     memset(data, 0xCB, MIN(size, 256));
@@ -308,6 +748,8 @@ NRT_MemInfo *NRT_MemInfo_alloc_safe_aligned_external(size_t size, unsigned align
     NRT_MemInfo *mi;
     NRT_Debug(nrt_debug_print("NRT_MemInfo_alloc_safe_aligned_external %p\n", allocator));
     void *data = nrt_allocate_meminfo_and_data_align(size, align, &mi, allocator);
+    if (data == NULL)
+        return NULL;
     /* Only fill up a couple cachelines with debug markers, to minimize
        overhead. */
     memset(data, 0xCB, MIN(size, 256));
@@ -321,21 +763,30 @@ void NRT_dealloc(NRT_MemInfo *mi) {
     NRT_Debug(nrt_debug_print("NRT_dealloc meminfo: %p external_allocator: %p\n", mi, mi->external_allocator));
     if (mi->external_allocator) {
         mi->external_allocator->free(mi, mi->external_allocator->opaque_data);
+        /* Balance the count made in NRT_Allocate_External() */
+        TheMSys.atomic_inc(&TheMSys.stats_free);
     } else {
         NRT_Free(mi);
     }
 }
 
 void NRT_MemInfo_destroy(NRT_MemInfo *mi) {
+    if (mi->size && !nrt_is_arena_allocator(mi->external_allocator))
+        nrt_update_stats_bytes((size_t) 0 - mi->size);
     NRT_dealloc(mi);
     TheMSys.atomic_inc(&TheMSys.stats_mi_free);
 }
 
 void NRT_MemInfo_acquire(NRT_MemInfo *mi) {
+    NRT_ThreadState *state = nrt_thread_state_active();
     NRT_Debug(nrt_debug_print("NRT_MemInfo_acquire %p refct=%zu\n", mi,
-                                                            mi->refct));
-    assert(mi->refct > 0 && "RefCt cannot be zero");
-    TheMSys.atomic_inc(&mi->refct);
+                              NRT_MemInfo_refcount(mi)));
+    if (nrt_is_owner(state, mi)) {
+        assert(mi->local_refct > 0 && "RefCt cannot be zero");
+        mi->local_refct++;
+    } else {
+        nrt_refct_add(mi, NRT_REFCT_ONE);
+    }
 }
 
 void NRT_MemInfo_call_dtor(NRT_MemInfo *mi) {
@@ -348,12 +799,53 @@ void NRT_MemInfo_call_dtor(NRT_MemInfo *mi) {
 }
 
 void NRT_MemInfo_release(NRT_MemInfo *mi) {
+    NRT_ThreadState *state = nrt_thread_state_active();
+    void *old, *new;
+    size_t refct;
     NRT_Debug(nrt_debug_print("NRT_MemInfo_release %p refct=%zu\n", mi,
-                                                            mi->refct));
-    assert (mi->refct > 0 && "RefCt cannot be 0");
-    /* RefCt drop to zero */
-    if (TheMSys.atomic_dec(&mi->refct) == 0) {
+                              NRT_MemInfo_refcount(mi)));
+    if (nrt_is_owner(state, mi)) {
+        /* Fast path: non-atomic release by the owner */
+        assert (mi->local_refct > 0 && "RefCt cannot be 0");
+        if (--mi->local_refct == 0) {
+            /* Last local reference, hand over to the shared count */
+            if (nrt_refct_merge(mi) == NRT_REFCT_MERGED) {
+                NRT_MemInfo_call_dtor(mi);
+            }
+        }
+        if (nrt_merge_queue_pending(state)) {
+            nrt_merge_queue_drain(state, NULL);
+        }
+        return;
+    }
+    old = (void *) mi->refct;
+    do {
+        refct = (size_t) old - NRT_REFCT_ONE;
+        if (!(refct & NRT_REFCT_MERGED) && NRT_REFCT_COUNT(refct) < 0) {
+            /* The owner may hold the last references */
+            refct |= NRT_REFCT_QUEUED;
+        }
+        new = (void *) refct;
+    } while (!TheMSys.atomic_cas((void **) &mi->refct, old, new, &old));
+
+    if (refct == NRT_REFCT_MERGED) {
+        /* RefCt drop to zero */
         NRT_MemInfo_call_dtor(mi);
+    } else if ((refct & NRT_REFCT_QUEUED) &&
+               !((size_t) old & NRT_REFCT_QUEUED)) {
+        nrt_merge_queue_push(mi);
+    }
+}
+
+void NRT_MemInfo_share(NRT_MemInfo *mi) {
+    NRT_ThreadState *state = nrt_thread_state_active();
+    if (nrt_is_owner(state, mi)) {
+        if (mi->local_refct == 1) {
+            nrt_refct_merge(mi);
+        } else {
+            mi->local_refct--;
+            nrt_refct_add(mi, NRT_REFCT_ONE);
+        }
     }
 }
 
@@ -375,7 +867,7 @@ void *NRT_MemInfo_parent(NRT_MemInfo *mi) {
 }
 
 void NRT_MemInfo_dump(NRT_MemInfo *mi, FILE *out) {
-    fprintf(out, "MemInfo %p refcount %zu\n", mi, mi->refct);
+    fprintf(out, "MemInfo %p refcount %zu\n", mi, NRT_MemInfo_refcount(mi));
 }
 
 /*
@@ -397,7 +889,10 @@ nrt_varsize_dtor(void *ptr, size_t size, void *info) {
 NRT_MemInfo *NRT_MemInfo_new_varsize(size_t size)
 {
     NRT_MemInfo *mi;
-    void *data = NRT_Allocate(size);
+    void *data;
+    if (nrt_over_memory_limit(size))
+        return NULL;
+    data = NRT_Allocate(size);
     if (data == NULL)
         return NULL;
 
@@ -422,9 +917,12 @@ void *NRT_MemInfo_varsize_alloc(NRT_MemInfo *mi, size_t size)
                         "with a non varsize-allocated meminfo");
         return NULL;  /* unreachable */
     }
+    if (size > mi->size && nrt_over_memory_limit(size - mi->size))
+        return NULL;
     mi->data = NRT_Allocate(size);
     if (mi->data == NULL)
         return NULL;
+    nrt_update_stats_bytes(size - mi->size);
     mi->size = size;
     NRT_Debug(nrt_debug_print("NRT_MemInfo_varsize_alloc %p size=%zu "
                               "-> data=%p\n", mi, size, mi->data));
@@ -438,9 +936,12 @@ void *NRT_MemInfo_varsize_realloc(NRT_MemInfo *mi, size_t size)
                         "with a non varsize-allocated meminfo");
         return NULL;  /* unreachable */
     }
+    if (size > mi->size && nrt_over_memory_limit(size - mi->size))
+        return NULL;
     mi->data = NRT_Reallocate(mi->data, size);
     if (mi->data == NULL)
         return NULL;
+    nrt_update_stats_bytes(size - mi->size);
     mi->size = size;
     NRT_Debug(nrt_debug_print("NRT_MemInfo_varsize_realloc %p size=%zu "
                               "-> data=%p\n", mi, size, mi->data));
@@ -454,6 +955,287 @@ void NRT_MemInfo_varsize_free(NRT_MemInfo *mi, void *ptr)
         mi->data = NULL;
 }
 
+/*
+ * Memory-mapped file API.
+ *
+ * The MemInfo data points into a mapping that starts at the page boundary
+ * below the requested file offset; the length of the mapping is stored as
+ * the dtor info.  The MemInfo is created with a size of 0 so that mapped
+ * files don't count toward the NRT memory statistics and limit.
+ */
+
+#ifdef NRT_HAVE_MMAP
+static
+size_t nrt_pagesize(void) {
+    static size_t pagesize = 0;
+    if (pagesize == 0)
+        pagesize = (size_t) sysconf(_SC_PAGESIZE);
+    return pagesize;
+}
+
+/* Start of the mapping holding `ptr` */
+static
+char *nrt_mmap_base(void *ptr) {
+    return (char *) ptr - ((size_t) ptr & (nrt_pagesize() - 1));
+}
+#endif
+
+static void
+nrt_mmap_dtor(void *ptr, size_t size, void *info) {
+#ifdef NRT_HAVE_MMAP
+    NRT_Debug(nrt_debug_print("nrt_mmap_dtor %p\n", ptr));
+    munmap(nrt_mmap_base(ptr), (size_t) info);
+#endif
+}
+
+NRT_MemInfo *NRT_MemInfo_new_mmap(const char *path, size_t pathlen,
+                                  size_t offset, size_t *size, int mode)
+{
+#ifdef NRT_HAVE_MMAP
+    int fd, flags, prot, map_flags, saved_errno;
+    char *cpath, *base;
+    struct stat st;
+    size_t delta, end;
+    NRT_MemInfo *mi;
+
+    prot = PROT_READ | PROT_WRITE;
+    map_flags = MAP_SHARED;
+    switch (mode) {
+    case NRT_MMAP_READONLY:
+        flags = O_RDONLY;
+        prot = PROT_READ;
+        break;
+    case NRT_MMAP_READWRITE:
+        flags = O_RDWR;
+        break;
+    case NRT_MMAP_COPYONWRITE:
+        flags = O_RDONLY;
+        map_flags = MAP_PRIVATE;
+        break;
+    case NRT_MMAP_WRITE:
+        flags = O_RDWR | O_CREAT | O_TRUNC;
+        break;
+    default:
+        errno = EINVAL;
+        return NULL;
+    }
+
+    /* `path` needn't be NUL-terminated */
+    cpath = TheMSys.allocator.malloc(pathlen + 1);
+    if (cpath == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    memcpy(cpath, path, pathlen);
+    cpath[pathlen] = '\0';
+    fd = open(cpath, flags, 0666);
+    TheMSys.allocator.free(cpath);
+    if (fd < 0)
+        return NULL;
+
+    if (fstat(fd, &st))
+        goto error;
+    if (*size == NRT_MMAP_TO_END) {
+        if ((size_t) st.st_size < offset) {
+            errno = EINVAL;
+            goto error;
+        }
+        *size = (size_t) st.st_size - offset;
+    }
+    end = offset + *size;
+    if (*size == 0 || end < offset) {
+        errno = EINVAL;
+        goto error;
+    }
+    if ((size_t) st.st_size < end) {
+        /* Like np.memmap, extend writable files, never read past the end */
+        if (mode == NRT_MMAP_READONLY || mode == NRT_MMAP_COPYONWRITE) {
+            errno = EINVAL;
+            goto error;
+        }
+        if (ftruncate(fd, (off_t) end))
+            goto error;
+    }
+
+    delta = offset % nrt_pagesize();
+    base = mmap(NULL, *size + delta, prot, map_flags, fd,
+                (off_t) (offset - delta));
+    if (base == MAP_FAILED)
+        goto error;
+    /* The mapping keeps its own reference to the file */
+    close(fd);
+
+    mi = NRT_MemInfo_new(base + delta, 0, nrt_mmap_dtor,
+                         (void *) (*size + delta));
+    if (mi == NULL) {
+        munmap(base, *size + delta);
+        errno = ENOMEM;
+        return NULL;
+    }
+    NRT_Debug(nrt_debug_print("NRT_MemInfo_new_mmap offset=%zu size=%zu "
+                              "-> meminfo=%p\n", offset, *size, mi));
+    return mi;
+
+error:
+    saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
+    return NULL;
+#else
+    return NULL;
+#endif
+}
+
+int NRT_MemInfo_mmap_flush(NRT_MemInfo *mi, int sync) {
+    if (mi == NULL || mi->dtor != nrt_mmap_dtor)
+        return 1;
+#ifdef NRT_HAVE_MMAP
+    {
+        return msync(nrt_mmap_base(mi->data), (size_t) mi->dtor_info,
+                     sync ? MS_SYNC : MS_ASYNC) ? -1 : 0;
+    }
+#else
+    return 1;
+#endif
+}
+
+/*
+ * Arena allocation API.
+ *
+ * Each thread owns a "current" chunk from which MemInfo allocations are
+ * served by bumping a pointer.  Every allocation holds a reference on its
+ * chunk, and the owning thread holds one more while the chunk is current.
+ * Allocations made by a call typically all die before the call returns, at
+ * which point the chunk is recycled wholesale on the next allocation instead
+ * of going through the system allocator.  Allocations that escape simply
+ * keep their chunk alive until they are released, possibly from another
+ * thread, hence the atomic reference count.
+ *
+ * As an escaping allocation pins its whole chunk, the memory stats and the
+ * memory limit count the chunks rather than the MemInfos carved out of them.
+ */
+
+/* Default size of an arena chunk */
+#define NRT_ARENA_CHUNK_SIZE (1 << 20)
+/* Larger allocations bypass the arena */
+#define NRT_ARENA_MAX_ALLOC (NRT_ARENA_CHUNK_SIZE / 8)
+/* Alignment of the blocks handed out by the arena */
+#define NRT_ARENA_ALIGN 16
+#define NRT_ARENA_ROUND(n) (((n) + NRT_ARENA_ALIGN - 1) & ~((size_t)NRT_ARENA_ALIGN - 1))
+
+typedef struct {
+    size_t refct;       /* live blocks + 1 while current in its thread */
+    size_t used;        /* bump offset, only touched by the owner thread */
+    size_t capacity;    /* bytes available after the header */
+} NRT_ArenaChunk;
+
+/* Every block is prefixed with a pointer to its chunk */
+#define NRT_ARENA_CHUNK_HEADER NRT_ARENA_ROUND(sizeof(NRT_ArenaChunk))
+#define NRT_ARENA_BLOCK_HEADER NRT_ARENA_ROUND(sizeof(NRT_ArenaChunk *))
+
+static THREAD_LOCAL(NRT_ArenaChunk *) nrt_arena_current;
+
+/* Whether only the owner thread's reference on the chunk remains */
+static
+int nrt_arena_chunk_idle(NRT_ArenaChunk *chunk) {
+    void *old;
+    /* A compare-and-swap storing the same value is an acquire load */
+    return TheMSys.atomic_cas((void **) &chunk->refct, (void *) 1,
+                              (void *) 1, &old);
+}
+
+static
+NRT_ArenaChunk *nrt_arena_chunk_new(size_t capacity) {
+    NRT_ArenaChunk *chunk;
+    if (nrt_over_memory_limit(NRT_ARENA_CHUNK_HEADER + capacity))
+        return NULL;
+    chunk = TheMSys.allocator.malloc(NRT_ARENA_CHUNK_HEADER + capacity);
+    NRT_Debug(nrt_debug_print("nrt_arena_chunk_new %p capacity=%zu\n",
+                              chunk, capacity));
+    if (chunk == NULL)
+        return NULL;
+    nrt_update_stats_bytes(NRT_ARENA_CHUNK_HEADER + capacity);
+    chunk->refct = 1;
+    chunk->used = 0;
+    chunk->capacity = capacity;
+    return chunk;
+}
+
+static
+void nrt_arena_chunk_decref(NRT_ArenaChunk *chunk) {
+    if (TheMSys.atomic_dec(&chunk->refct) == 0) {
+        NRT_Debug(nrt_debug_print("nrt_arena_chunk_free %p\n", chunk));
+        nrt_update_stats_bytes((size_t) 0 -
+                               (NRT_ARENA_CHUNK_HEADER + chunk->capacity));
+        TheMSys.allocator.free(chunk);
+    }
+}
+
+static
+void *nrt_arena_malloc(size_t size, void *opaque_data) {
+    NRT_ArenaChunk *chunk = nrt_arena_current;
+    size_t need = NRT_ARENA_BLOCK_HEADER + NRT_ARENA_ROUND(size);
+    char *block;
+
+    /* Only the owner thread ever increments the refcount, so seeing 1 here
+       means every block served from the chunk has been released.  The load
+       must acquire so that the releases happen before the reuse. */
+    if (chunk != NULL && nrt_arena_chunk_idle(chunk)) {
+        chunk->used = 0;
+    }
+    if (chunk == NULL || chunk->used + need > chunk->capacity) {
+        if (chunk != NULL) {
+            /* Retire the chunk; the last block released will free it */
+            nrt_arena_current = NULL;
+            nrt_arena_chunk_decref(chunk);
+        }
+        chunk = nrt_arena_chunk_new(need > NRT_ARENA_CHUNK_SIZE
+                                    ? need : NRT_ARENA_CHUNK_SIZE);
+        if (chunk == NULL)
+            return NULL;
+        nrt_arena_current = chunk;
+    }
+    block = (char *) chunk + NRT_ARENA_CHUNK_HEADER + chunk->used;
+    chunk->used += need;
+    TheMSys.atomic_inc(&chunk->refct);
+    *(NRT_ArenaChunk **) block = chunk;
+    NRT_Debug(nrt_debug_print("nrt_arena_malloc chunk=%p block=%p size=%zu\n",
+                              chunk, block, size));
+    return block + NRT_ARENA_BLOCK_HEADER;
+}
+
+static
+void nrt_arena_free(void *ptr, void *opaque_data) {
+    char *block = (char *) ptr - NRT_ARENA_BLOCK_HEADER;
+    NRT_Debug(nrt_debug_print("nrt_arena_free block=%p\n", block));
+    nrt_arena_chunk_decref(*(NRT_ArenaChunk **) block);
+}
+
+/* Shared by all threads as MemInfos may be released anywhere */
+static NRT_ExternalAllocator nrt_arena_allocator = {
+    nrt_arena_malloc,
+    NULL,           /* blocks are never reallocated */
+    nrt_arena_free,
+    NULL
+};
+
+NRT_MemInfo *NRT_MemInfo_alloc_safe_aligned_arena(size_t size, unsigned align)
+{
+    if (size > NRT_ARENA_MAX_ALLOC) {
+        return NRT_MemInfo_alloc_safe_aligned(size, align);
+    }
+    return NRT_MemInfo_alloc_safe_aligned_external(size, align,
+                                                   &nrt_arena_allocator);
+}
+
+void NRT_MemSys_release_arena(void) {
+    NRT_ArenaChunk *chunk = nrt_arena_current;
+    if (chunk != NULL) {
+        nrt_arena_current = NULL;
+        nrt_arena_chunk_decref(chunk);
+    }
+}
+
 /*
  * Low-level allocation wrappers.
  */
@@ -29,6 +29,17 @@ typedef int (*NRT_atomic_cas_func)(void * volatile *ptr, void *cmp, void *repl,
 
 typedef struct MemSys NRT_MemSys;
 
+typedef void (*NRT_soft_limit_func)(size_t live_bytes, void *arg);
+
+/* Modes for NRT_MemInfo_new_mmap(), matching np.memmap's */
+#define NRT_MMAP_READONLY       0   /* "r" */
+#define NRT_MMAP_READWRITE      1   /* "r+" */
+#define NRT_MMAP_COPYONWRITE    2   /* "c" */
+#define NRT_MMAP_WRITE          3   /* "w+" */
+
+/* Map from the offset to the end of the file */
+#define NRT_MMAP_TO_END         ((size_t) -1)
+
 typedef void *(*NRT_malloc_func)(size_t size);
 typedef void *(*NRT_realloc_func)(void *ptr, size_t new_size);
 typedef void (*NRT_free_func)(void *ptr);
@@ -86,6 +97,26 @@ VISIBILITY_HIDDEN
 size_t NRT_MemSys_get_stats_mi_alloc(void);
 VISIBILITY_HIDDEN
 size_t NRT_MemSys_get_stats_mi_free(void);
+/* Number of bytes managed by live MemInfos */
+VISIBILITY_HIDDEN
+size_t NRT_MemSys_get_stats_bytes(void);
+
+/*
+ * Set the memory limit in bytes; 0 means unlimited.
+ * Allocations that would make the bytes managed by live MemInfos exceed the
+ * limit fail and return NULL.
+ */
+VISIBILITY_HIDDEN
+void NRT_MemSys_set_memory_limit(size_t limit);
+
+/*
+ * Register a function called whenever the bytes managed by live MemInfos
+ * grow past `threshold`.  It is called from the allocating thread, with the
+ * new number of bytes and `arg`.  A NULL `func` unregisters it.
+ */
+VISIBILITY_HIDDEN
+void NRT_MemSys_set_soft_limit(size_t threshold, NRT_soft_limit_func func,
+                               void *arg);
 
 /* Memory Info API */
 
@@ -112,7 +143,9 @@ size_t NRT_MemInfo_refcount(NRT_MemInfo *mi);
 
 /*
  * Allocate memory of `size` bytes and return a pointer to a MemInfo structure
- * that describes the allocation
+ * that describes the allocation.
+ * All the allocation functions below return NULL if the allocation fails or
+ * exceeds the memory limit.
  */
 VISIBILITY_HIDDEN
 NRT_MemInfo *NRT_MemInfo_alloc(size_t size);
@@ -146,6 +179,31 @@ NRT_MemInfo *NRT_MemInfo_alloc_safe_aligned(size_t size, unsigned align);
 
 NRT_MemInfo *NRT_MemInfo_alloc_safe_aligned_external(size_t size, unsigned align, NRT_ExternalAllocator *allocator);
 
+/*
+ * Like NRT_MemInfo_alloc_safe_aligned but serve the allocation from the
+ * calling thread's arena.  The arena memory is recycled once every MemInfo
+ * allocated from it has been released.  Large allocations fall back to
+ * NRT_MemInfo_alloc_safe_aligned.
+ */
+VISIBILITY_HIDDEN
+NRT_MemInfo *NRT_MemInfo_alloc_safe_aligned_arena(size_t size, unsigned align);
+
+/*
+ * Drop the calling thread's reference to its current arena chunk.
+ * The chunk is freed once the MemInfos still using it are released.
+ */
+VISIBILITY_HIDDEN
+void NRT_MemSys_release_arena(void);
+
+/*
+ * Park the calling thread until its next use of the NRT: meanwhile, other
+ * threads releasing MemInfos it owns merge them instead of queueing them.
+ * Called when compiled code returns to the interpreter, as the thread may
+ * then stay idle for long.
+ */
+VISIBILITY_HIDDEN
+void NRT_MemSys_park_thread(void);
+
 /*
  * Internal API.
  * Release a MemInfo. Calls NRT_MemSys_insert_meminfo.
@@ -165,6 +223,14 @@ void NRT_MemInfo_acquire(NRT_MemInfo* mi);
 VISIBILITY_HIDDEN
 void NRT_MemInfo_release(NRT_MemInfo* mi);
 
+/*
+ * Turn a reference held by the calling thread into one that can be released
+ * from any thread without going through the owner.  Used when a reference
+ * is handed over to Python.
+ */
+VISIBILITY_HIDDEN
+void NRT_MemInfo_share(NRT_MemInfo* mi);
+
 /*
  * Internal/Compiler API.
  * Invoke the registered destructor of a MemInfo.
@@ -211,6 +277,25 @@ void *NRT_MemInfo_varsize_realloc(NRT_MemInfo *mi, size_t size);
 VISIBILITY_HIDDEN
 void NRT_MemInfo_varsize_free(NRT_MemInfo *mi, void *ptr);
 
+/*
+ * Map `*size` bytes at `offset` in the file at `path` (`pathlen` bytes,
+ * not necessarily NUL-terminated), with one of the NRT_MMAP_* modes.
+ * If `*size` is NRT_MMAP_TO_END, the file is mapped up to its end and
+ * `*size` is set to the mapped length.  The mapping is released with the
+ * MemInfo.  Returns NULL and sets errno on error.
+ */
+VISIBILITY_HIDDEN
+NRT_MemInfo *NRT_MemInfo_new_mmap(const char *path, size_t pathlen,
+                                  size_t offset, size_t *size, int mode);
+
+/*
+ * Write back the file mapping of a MemInfo created by NRT_MemInfo_new_mmap(),
+ * waiting for completion if `sync` is true.  Returns 0 on success, -1 on
+ * error (with errno set) and 1 if the MemInfo does not map a file.
+ */
+VISIBILITY_HIDDEN
+int NRT_MemInfo_mmap_flush(NRT_MemInfo *mi, int sync);
+
 /*
  * Print debug info to FILE
  */
@@ -6,7 +6,7 @@ from llvmlite import binding as ll
 
 from numba.core.compiler_lock import global_compiler_lock
 from numba.core.typing.typeof import typeof_impl
-from numba.core import types
+from numba.core import config, types
 from numba.core.runtime import _nrt_python as _nrt
 
 _nrt_mstats = namedtuple("nrt_mstats", ["alloc", "free", "mi_alloc", "mi_free"])
@@ -44,6 +44,9 @@ class _Runtime(object):
         _nrt.memsys_set_atomic_inc_dec(self._ptr_inc, self._ptr_dec)
         _nrt.memsys_set_atomic_cas(self._ptr_cas)
 
+        if config.NRT_MEMORY_LIMIT:
+            self.set_memory_limit(config.NRT_MEMORY_LIMIT)
+
         self._init = True
 
     def _init_guard(self):
@@ -94,6 +97,38 @@ class _Runtime(object):
             mi = _nrt.meminfo_alloc(size)
         return MemInfo(mi)
 
+    def release_arena(self):
+        """
+        Release the calling thread's NRT arena chunk.  The memory is returned
+        to the system once all MemInfos allocated from it are released.
+        Exiting threads release their chunk automatically.
+        """
+        _nrt.memsys_release_arena()
+
+    def set_memory_limit(self, limit):
+        """
+        Limit the number of bytes held by live NRT allocations to `limit`.
+        Allocations exceeding the limit raise MemoryError.  A `limit` of 0
+        removes the limit.
+        """
+        _nrt.memsys_set_memory_limit(limit)
+
+    def set_memory_soft_limit(self, threshold, callback):
+        """
+        Call `callback(nbytes)` whenever the number of bytes held by live
+        NRT allocations grows past `threshold`.  The callback may run on any
+        thread, including from nopython code; exceptions it raises are
+        printed and ignored.  A `callback` of None unregisters it.  The
+        callbacks ever registered are kept alive until the process exits.
+        """
+        _nrt.memsys_set_soft_limit(threshold, callback)
+
+    def get_memory_usage(self):
+        """
+        Returns the number of bytes held by live NRT allocations.
+        """
+        return _nrt.memsys_get_stats_bytes()
+
     def get_allocation_stats(self):
         """
         Returns a namedtuple of (alloc, free, mi_alloc, mi_free) for count of
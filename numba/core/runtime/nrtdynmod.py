@@ -19,6 +19,10 @@ _meminfo_struct_type = ir.LiteralStructType([
     _pointer_type,  # void *dtor_info
     _pointer_type,  # void *data
     _word_type,     # size_t size
+    _pointer_type,  # NRT_ExternalAllocator *external_allocator
+    _pointer_type,  # NRT_ThreadState *owner
+    _word_type,     # size_t local_refct
+    _pointer_type,  # NRT_MemInfo *merge_next
     ])
 
 
@@ -40,7 +44,7 @@ def _define_nrt_meminfo_data(module):
     builder.ret(data_ptr)
 
 
-def _define_nrt_incref(module, atomic_incr):
+def _define_nrt_incref(module):
     """
     Implement NRT_incref in the module
     """
@@ -48,6 +52,10 @@ def _define_nrt_incref(module, atomic_incr):
                                               name="NRT_incref")
     # Cannot inline this for refcount pruning to work
     fn_incref.attributes.add('noinline')
+    # The refcount is biased towards the owner thread of the MemInfo,
+    # see NRT_MemInfo_acquire() in nrt.c
+    acquire = module.add_function(incref_decref_ty,
+                                  name="NRT_MemInfo_acquire")
     builder = ir.IRBuilder(fn_incref.append_basic_block())
     [ptr] = fn_incref.args
     is_null = builder.icmp_unsigned("==", ptr, cgutils.get_null_value(ptr.type))
@@ -55,13 +63,12 @@ def _define_nrt_incref(module, atomic_incr):
         builder.ret_void()
 
     if _debug_print:
-        cgutils.printf(builder, "*** NRT_Incref %zu [%p]\n", builder.load(ptr),
-                       ptr)
-    builder.call(atomic_incr, [builder.bitcast(ptr, atomic_incr.args[0].type)])
+        cgutils.printf(builder, "*** NRT_Incref [%p]\n", ptr)
+    builder.call(acquire, [ptr])
     builder.ret_void()
 
 
-def _define_nrt_decref(module, atomic_decr):
+def _define_nrt_decref(module):
     """
     Implement NRT_decref in the module
     """
@@ -69,8 +76,10 @@ def _define_nrt_decref(module, atomic_decr):
                                               name="NRT_decref")
     # Cannot inline this for refcount pruning to work
     fn_decref.attributes.add('noinline')
-    calldtor = module.add_function(ir.FunctionType(ir.VoidType(), [_pointer_type]),
-                                   name="NRT_MemInfo_call_dtor")
+    # Calls the destructor when the last reference is released,
+    # see NRT_MemInfo_release() in nrt.c
+    release = module.add_function(incref_decref_ty,
+                                  name="NRT_MemInfo_release")
 
     builder = ir.IRBuilder(fn_decref.append_basic_block())
     [ptr] = fn_decref.args
@@ -79,24 +88,9 @@ def _define_nrt_decref(module, atomic_decr):
         builder.ret_void()
 
     if _debug_print:
-        cgutils.printf(builder, "*** NRT_Decref %zu [%p]\n", builder.load(ptr),
-                       ptr)
-
-    # For memory fence usage, see https://llvm.org/docs/Atomics.html
-
-    # A release fence is used before the relevant write operation.
-    # No-op on x86.  On POWER, it lowers to lwsync.
-    builder.fence("release")
-    newrefct = builder.call(atomic_decr,
-                            [builder.bitcast(ptr, atomic_decr.args[0].type)])
-
-    refct_eq_0 = builder.icmp_unsigned("==", newrefct,
-                                       ir.Constant(newrefct.type, 0))
-    with cgutils.if_unlikely(builder, refct_eq_0):
-        # An acquire fence is used after the relevant read operation.
-        # No-op on x86.  On POWER, it lowers to lwsync.
-        builder.fence("acquire")
-        builder.call(calldtor, [ptr])
+        cgutils.printf(builder, "*** NRT_Decref [%p]\n", ptr)
+
+    builder.call(release, [ptr])
     builder.ret_void()
 
 
@@ -132,11 +126,13 @@ def _define_atomic_inc_dec(module, op, ordering):
     return fn_atomic
 
 
-def _define_atomic_cas(module, ordering):
+def _define_atomic_cas(module, ordering, failordering=None):
     """Define a llvm function for atomic compare-and-swap.
     The generated function is a direct wrapper of the LLVM cmpxchg with the
     difference that the a int indicate success (1) or failure (0) is returned
     and the last argument is a output pointer for storing the old value.
+    Argument ``failordering`` is the memory ordering on failure (defaults to
+    ``ordering``).
 
     Note
     ----
@@ -151,7 +147,8 @@ def _define_atomic_cas(module, ordering):
     [ptr, cmp, repl, oldptr] = fn_cas.args
     bb = fn_cas.append_basic_block()
     builder = ir.IRBuilder(bb)
-    outtup = builder.cmpxchg(ptr, cmp, repl, ordering=ordering)
+    outtup = builder.cmpxchg(ptr, cmp, repl, ordering=ordering,
+                             failordering=failordering)
     old, ok = cgutils.unpack_tuple(builder, outtup, 2)
     builder.store(old, oldptr)
     builder.ret(builder.zext(ok, ftype.return_type))
@@ -186,13 +183,18 @@ def create_nrt_module(ctx):
     # Implement LLVM module with atomic ops
     ir_mod = library.create_ir_module("nrt_module")
 
-    atomic_inc = _define_atomic_inc_dec(ir_mod, "add", ordering='monotonic')
-    atomic_dec = _define_atomic_inc_dec(ir_mod, "sub", ordering='monotonic')
-    _define_atomic_cas(ir_mod, ordering='monotonic')
+    # The decrement and the CAS (which the shared MemInfo refcounts and
+    # merge queues rely on, see nrt.c) must order the writes to the payload
+    # before a release, and those of other threads before calling the
+    # destructor or walking a merge queue.  For memory ordering usage, see
+    # https://llvm.org/docs/Atomics.html
+    _define_atomic_inc_dec(ir_mod, "add", ordering='monotonic')
+    _define_atomic_inc_dec(ir_mod, "sub", ordering='acq_rel')
+    _define_atomic_cas(ir_mod, ordering='acq_rel', failordering='acquire')
 
     _define_nrt_meminfo_data(ir_mod)
-    _define_nrt_incref(ir_mod, atomic_inc)
-    _define_nrt_decref(ir_mod, atomic_dec)
+    _define_nrt_incref(ir_mod)
+    _define_nrt_decref(ir_mod)
 
     _define_nrt_unresolved_abort(ctx, ir_mod)
 
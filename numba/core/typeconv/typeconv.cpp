@@ -8,42 +8,70 @@
 
 // ------ TypeManager ------
 
+static TCCRecord make_empty_record(Type empty) {
+    TCCRecord data;
+    data.key = TypePair(empty, empty);
+    data.val = TCC_FALSE;
+    return data;
+}
+
 TCCMap::TCCMap()
-    : nb_records(0)
+    : records(TCCMAP_INITIAL_SIZE, make_empty_record(TCCMAP_EMPTY)),
+      mask(TCCMAP_INITIAL_SIZE - 1), nb_records(0)
 {
 }
 
 unsigned int TCCMap::hash(const TypePair &key) const {
-    const int mult = 1000003;
-    int x = 0x345678;
-    x = (x ^ key.first) * mult;
-    x = (x ^ key.second);
+    // Typecodes are small consecutive integers: mix them well enough
+    // for linear probing not to cluster.
+    unsigned int x = (unsigned int) key.first * 0x9E3779B1u;
+    x ^= (unsigned int) key.second + 0x7F4A7C15u + (x << 6) + (x >> 2);
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
     return x;
 }
 
 void TCCMap::insert(const TypePair &key, TypeCompatibleCode val) {
-    unsigned int i = hash(key) & (TCCMAP_SIZE - 1);
-    TCCMapBin &bin = records[i];
-    TCCRecord data;
-    data.key = key;
-    data.val = val;
-    for (unsigned int j = 0; j < bin.size(); ++j) {
-        if (bin[j].key == key) {
-            bin[j].val = val;
+    unsigned int i = hash(key) & mask;
+    while (records[i].key.first != TCCMAP_EMPTY) {
+        if (records[i].key == key) {
+            records[i].val = val;
             return;
         }
+        i = (i + 1) & mask;
     }
-    bin.push_back(data);
+    records[i].key = key;
+    records[i].val = val;
     nb_records++;
+    if (2 * nb_records > mask) {
+        grow();
+    }
+}
+
+void TCCMap::grow() {
+    std::vector<TCCRecord> old(2 * records.size(),
+                               make_empty_record(TCCMAP_EMPTY));
+    old.swap(records);
+    mask = records.size() - 1;
+    for (unsigned int j = 0; j < old.size(); ++j) {
+        if (old[j].key.first == TCCMAP_EMPTY)
+            continue;
+        unsigned int i = hash(old[j].key) & mask;
+        while (records[i].key.first != TCCMAP_EMPTY) {
+            i = (i + 1) & mask;
+        }
+        records[i] = old[j];
+    }
 }
 
 TypeCompatibleCode TCCMap::find(const TypePair &key) const {
-    unsigned int i = hash(key) & (TCCMAP_SIZE - 1);
-    const TCCMapBin &bin = records[i];
-    for (unsigned int j = 0; j < bin.size(); ++j) {
-        if (bin[j].key == key) {
-            return bin[j].val;
+    unsigned int i = hash(key) & mask;
+    while (records[i].key.first != TCCMAP_EMPTY) {
+        if (records[i].key == key) {
+            return records[i].val;
         }
+        i = (i + 1) & mask;
     }
     return TCC_FALSE;
 }
@@ -70,6 +98,11 @@ inline bool Rating::operator == (const Rating &other) const {
 
 // ------ TypeManager ------
 
+TypeManager::TypeManager()
+    : generation(0)
+{
+}
+
 bool TypeManager::canPromote(Type from, Type to) const {
     return isCompatible(from, to) == TCC_PROMOTE;
 }
@@ -97,6 +130,7 @@ void TypeManager::addSafeConversion(Type from, Type to) {
 void TypeManager::addCompatibility(Type from, Type to, TypeCompatibleCode tcc) {
     TypePair pair(from, to);
     tccmap.insert(pair, tcc);
+    generation++;
 }
 
 TypeCompatibleCode TypeManager::isCompatible(Type from, Type to) const {
@@ -30,8 +30,11 @@ struct TCCRecord {
     TypeCompatibleCode val;
 };
 
-typedef std::vector<TCCRecord> TCCMapBin;
-
+/*
+An open-addressing hash table (with linear probing) of type pairs.
+Records are stored inline so that a lookup usually touches a single
+cache line; the table doubles when it becomes half full.
+*/
 class TCCMap {
 public:
     TCCMap();
@@ -40,10 +43,15 @@ public:
     void insert(const TypePair &key, TypeCompatibleCode val);
     TypeCompatibleCode find(const TypePair &key) const;
 private:
+    void grow();
+
     /* Must be a power of two */
-    static const int TCCMAP_SIZE = 512;
-    TCCMapBin records[TCCMAP_SIZE];
-    int nb_records;
+    static const unsigned int TCCMAP_INITIAL_SIZE = 512;
+    /* Key of the unused slots; typecodes are never negative */
+    static const Type TCCMAP_EMPTY = -1;
+    std::vector<TCCRecord> records;
+    unsigned int mask;
+    unsigned int nb_records;
 };
 
 struct Rating {
@@ -60,6 +68,8 @@ struct Rating {
 
 class TypeManager{
 public:
+    TypeManager();
+
     bool canPromote(Type from, Type to) const;
     bool canUnsafeConvert(Type from, Type to) const;
     bool canSafeConvert(Type from, Type to) const;
@@ -81,6 +91,12 @@ public:
                        bool exact_match_required
                       ) const;
 
+    /**
+    Incremented whenever a compatibility is added, so that cached
+    overload selections can be invalidated.
+    */
+    unsigned int getGeneration() const { return generation; }
+
 private:
     int _selectOverload(const Type sig[], const Type ovsigs[], int &selected,
                         int sigsz, int ovct, bool allow_unsafe,
@@ -88,6 +104,7 @@ private:
                         Rating ratings[], int candidates[]) const;
 
     TCCMap tccmap;
+    unsigned int generation;
 };
 
 
@@ -526,3 +526,27 @@ class UnicodeIteratorType(SimpleIteratorType):
         name = "iter_unicode"
         self.data = dtype
         super(UnicodeIteratorType, self).__init__(name, dtype)
+
+
+class ArrowArray(Type):
+    """
+    A read-only view of a non-nested array exported through the Arrow
+    C Data Interface.  *format* is the Arrow format string and *dtype*
+    the item type: a number type, or unicode_type for string arrays.
+    """
+    mutable = False
+
+    def __init__(self, dtype, format):
+        self.dtype = dtype
+        self.format = format
+        name = "ArrowArray({0}, {1!r})".format(dtype, format)
+        super(ArrowArray, self).__init__(name)
+
+    @property
+    def key(self):
+        return self.dtype, self.format
+
+    @property
+    def is_string(self):
+        # utf8 and large_utf8
+        return self.format in ('u', 'U')
@@ -517,6 +517,20 @@ class ArrayFlags(Type):
         return self.array_type
 
 
+class DLPackCapsule(Type):
+    """
+    The type of a DLPack capsule exporting an array of type *arytype*.
+    """
+    def __init__(self, arytype):
+        self.array_type = arytype
+        name = "DLPackCapsule({0})".format(self.array_type)
+        super(DLPackCapsule, self).__init__(name)
+
+    @property
+    def key(self):
+        return self.array_type
+
+
 class NestedArray(Array):
     """
     A NestedArray is an array nested within a structured type (which are "void"
@@ -41,12 +41,20 @@ class Rating(object):
 
 class CallStack(Sequence):
     """
-    A compile-time call stack
+    A compile-time call stack.  Each thread has its own, as compilations on
+    different threads may overlap (see _CompilerLock.released()).
     """
 
     def __init__(self):
-        self._stack = []
-        self._lock = threading.RLock()
+        self._local = threading.local()
+
+    @property
+    def _stack(self):
+        try:
+            return self._local.stack
+        except AttributeError:
+            self._local.stack = []
+            return self._local.stack
 
     def __getitem__(self, index):
         """
@@ -64,13 +72,11 @@ class CallStack(Sequence):
         if self.match(func_id.func, args):
             msg = "compiler re-entrant to the same function signature"
             raise RuntimeError(msg)
-        self._lock.acquire()
         self._stack.append(CallFrame(typeinfer, func_id, args))
         try:
             yield
         finally:
             self._stack.pop()
-            self._lock.release()
 
     def finditer(self, py_func):
         """
@@ -18,14 +18,16 @@ class Purpose(enum.Enum):
     constant = 2
 
 
-_TypeofContext = namedtuple("_TypeofContext", ("purpose",))
+_TypeofContext = namedtuple("_TypeofContext", ("purpose", "keep_exports"))
 
-def typeof(val, purpose=Purpose.argument):
+def typeof(val, purpose=Purpose.argument, keep_exports=False):
     """
     Get the Numba type of a Python value for the given purpose.
+    If *keep_exports* is true, the arrays exported by *val* for typing
+    (DLPack, Arrow) are kept for unboxing it in the same call.
     """
     # Note the behaviour for Purpose.argument must match _typeof.c.
-    c = _TypeofContext(purpose)
+    c = _TypeofContext(purpose, keep_exports)
     ty = typeof_impl(val, c)
     if ty is None:
         msg = _termcolor.errmsg(
@@ -43,6 +45,14 @@ def typeof_impl(val, c):
     if tp is not None:
         return tp
 
+    tp = _typeof_arrow(val, c)
+    if tp is not None:
+        return tp
+
+    tp = _typeof_dlpack(val, c)
+    if tp is not None:
+        return tp
+
     # cffi is handled here as it does not expose a public base class
     # for exported functions or CompiledFFI instances.
     from numba.core.typing import cffi_utils
@@ -72,6 +82,61 @@ def _typeof_buffer(val, c):
                       readonly=m.readonly)
 
 
+# Supported Arrow format strings
+_arrow_formats = {
+    'c': types.int8,
+    'C': types.uint8,
+    's': types.int16,
+    'S': types.uint16,
+    'i': types.int32,
+    'I': types.uint32,
+    'l': types.int64,
+    'L': types.uint64,
+    'f': types.float32,
+    'g': types.float64,
+    'u': types.unicode_type,
+    'U': types.unicode_type,
+}
+
+
+def _typeof_arrow(val, c):
+    # Objects exporting an array through the Arrow C Data Interface
+    # (see NRT_adapt_arrow_from_python()).  This comes before DLPack since
+    # it also describes the validity bitmap.
+    if (c.purpose != Purpose.argument or
+            not hasattr(type(val), '__arrow_c_array__')):
+        return
+    from numba.core.runtime import _nrt_python
+    fmt = _nrt_python.arrow_describe(val, c.keep_exports)
+    dtype = _arrow_formats.get(fmt)
+    if dtype is not None:
+        return types.ArrowArray(dtype, fmt)
+
+
+def _typeof_dlpack(val, c):
+    # Objects exporting a CPU tensor through DLPack are unboxed as arrays
+    # (see NRT_adapt_array_from_python())
+    if c.purpose != Purpose.argument or not hasattr(type(val), '__dlpack__'):
+        return
+    from numba.core.runtime import _nrt_python
+    desc = _nrt_python.dlpack_describe(val, c.keep_exports)
+    if desc is None:
+        return
+    code, bits, shape, strides = desc
+    try:
+        dtype = numpy_support.from_dlpack_dtype(code, bits)
+    except NotImplementedError:
+        return
+    # Strides are in items
+    if strides is None or numpy_support.is_contiguous(shape, strides, 1):
+        layout = 'C'
+    elif numpy_support.is_fortran(shape, strides, 1):
+        layout = 'F'
+    else:
+        layout = 'A'
+    return types.Array(dtype, len(shape), layout)
+
+
 @typeof_impl.register(ctypes._CFuncPtr)
 def typeof_ctypes_function(val, c):
     from .ctypes_utils import is_ctypes_funcptr, make_function_type
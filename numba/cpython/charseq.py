@@ -200,6 +200,8 @@ def _make_constant_bytes(context, builder, nbytes):
         nbytes = ir.Constant(bstr.nitems.type, nbytes)
 
     bstr.meminfo = context.nrt.meminfo_alloc(builder, nbytes)
+    cgutils.guard_memory_error(context, builder, bstr.meminfo,
+                               "cannot allocate bytes")
     bstr.nitems = nbytes
     bstr.itemsize = ir.Constant(bstr.itemsize.type, 1)
     bstr.data = context.nrt.meminfo_data(builder, bstr.meminfo)
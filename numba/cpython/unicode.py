@@ -257,6 +257,8 @@ def _malloc_string(typingctx, kind, char_bytes, length, is_ascii):
                                  builder.add(length_val,
                                              Constant(length_val.type, 1)))
         uni_str.meminfo = context.nrt.meminfo_alloc(builder, nbytes_val)
+        cgutils.guard_memory_error(context, builder, uni_str.meminfo,
+                                   "cannot allocate string")
         uni_str.kind = kind_val
         uni_str.is_ascii = is_ascii_val
         uni_str.length = length_val
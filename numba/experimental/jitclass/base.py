@@ -547,6 +547,8 @@ def ctor_impl(context, builder, sig, args):
         context.get_constant(types.uintp, alloc_size),
         imp_dtor(context, builder.module, inst_typ),
     )
+    cgutils.guard_memory_error(context, builder, meminfo,
+                               "cannot allocate jitclass instance")
     data_pointer = context.nrt.meminfo_data(builder, meminfo)
     data_pointer = builder.bitcast(data_pointer,
                                    alloc_type.as_pointer())
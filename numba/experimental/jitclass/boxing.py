@@ -76,6 +76,8 @@ def _specialize_box(typ):
         return _cache_specialized_box[typ]
     dct = {'__slots__': (),
            '_numba_type_': typ,
+           # Lets the C dispatcher read the type without calling Python
+           '_numba_type_attr_': '_numba_type_',
            '__doc__': typ.class_type.class_doc,
            }
     # Inject attributes as class properties
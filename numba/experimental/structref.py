@@ -309,6 +309,8 @@ def new(typingctx, struct_type):
             context.get_constant(types.uintp, alloc_size),
             imp_dtor(context, builder.module, inst_type),
         )
+        cgutils.guard_memory_error(context, builder, meminfo,
+                                   "cannot allocate structref instance")
         data_pointer = context.nrt.meminfo_data(builder, meminfo)
         data_pointer = builder.bitcast(data_pointer, alloc_type.as_pointer())
 
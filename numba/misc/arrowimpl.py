@@ -0,0 +1,177 @@
+"""
+Implementation of arrays exported through the Arrow C Data Interface
+(see types.ArrowArray).  The buffers are accessed in place; array views
+of them keep the Arrow array alive through its MemInfo.
+"""
+
+import operator
+
+import numpy as np
+
+from numba.core import types, cgutils
+from numba.core.extending import (intrinsic, overload, overload_attribute,
+                                  overload_method, make_attribute_wrapper,
+                                  register_jitable)
+from numba.core.pythonapi import (PY_UNICODE_1BYTE_KIND,
+                                  PY_UNICODE_2BYTE_KIND,
+                                  PY_UNICODE_4BYTE_KIND)
+from numba.cpython.unicode import _empty_string, _set_code_point
+from numba.np import arrayobj
+
+
+for _name in ('length', 'validity', 'values', 'offsets'):
+    make_attribute_wrapper(types.ArrowArray, _name, '_' + _name)
+make_attribute_wrapper(types.ArrowArray, 'offset', 'offset')
+make_attribute_wrapper(types.ArrowArray, 'null_count', 'null_count')
+
+
+@intrinsic
+def _is_null(typingctx, ptr):
+    def codegen(context, builder, sig, args):
+        return cgutils.is_null(builder, args[0])
+
+    return types.boolean(ptr), codegen
+
+
+@intrinsic
+def _buffer_view(typingctx, arr, ptr, start, count):
+    """
+    Make a read-only 1D array of the *count* items at *ptr* + *start*,
+    keeping the Arrow array *arr* alive.
+    """
+    arrayty = types.Array(ptr.dtype, 1, 'C', readonly=True)
+
+    def codegen(context, builder, sig, args):
+        arrow, data, start, count = args
+        arrowty = sig.args[0]
+        aryty = sig.return_type
+        meminfo = context.make_helper(builder, arrowty, value=arrow).meminfo
+        context.nrt.incref(builder, arrowty, arrow)
+
+        ary = arrayobj.make_array(aryty)(context, builder)
+        itemsize = context.get_abi_sizeof(context.get_data_type(aryty.dtype))
+        arrayobj.populate_array(ary,
+                                data=builder.gep(data, [start]),
+                                shape=[count],
+                                strides=[itemsize],
+                                itemsize=itemsize,
+                                meminfo=meminfo)
+        return ary._getvalue()
+
+    sig = arrayty(arr, ptr, types.intp, types.intp)
+    return sig, codegen
+
+
+@register_jitable
+def _decode_utf8(data, start, end):
+    # Arrow guarantees valid UTF-8.  The lead bytes give the number of
+    # code points and the widest one, hence the string kind.
+    length = 0
+    maxlead = 0
+    for i in range(start, end):
+        c = data[i]
+        if (c & 0xC0) != 0x80:
+            length += 1
+            maxlead = max(maxlead, c)
+    if maxlead < 0xC4:
+        kind = PY_UNICODE_1BYTE_KIND
+    elif maxlead < 0xF0:
+        kind = PY_UNICODE_2BYTE_KIND
+    else:
+        kind = PY_UNICODE_4BYTE_KIND
+    s = _empty_string(kind, length, maxlead < 0x80)
+    i = start
+    for k in range(length):
+        c = data[i]
+        if c < 0x80:
+            n = 1
+        elif c < 0xE0:
+            c &= 0x1F
+            n = 2
+        elif c < 0xF0:
+            c &= 0x0F
+            n = 3
+        else:
+            c &= 0x07
+            n = 4
+        for j in range(i + 1, i + n):
+            c = (c << 6) | (data[j] & 0x3F)
+        _set_code_point(s, k, np.uint32(c))
+        i += n
+    return s
+
+
+@register_jitable
+def _wrap_index(arr, idx):
+    if idx < 0:
+        idx += arr._length
+    return arr.offset + idx
+
+
+@overload(len)
+def arrow_len(arr):
+    if isinstance(arr, types.ArrowArray):
+        return lambda arr: arr._length
+
+
+@overload(operator.getitem)
+def arrow_getitem(arr, idx):
+    if (not isinstance(arr, types.ArrowArray) or
+            not isinstance(idx, types.Integer)):
+        return
+    # Null slots are not checked: they hold unspecified values
+    if arr.is_string:
+        def impl(arr, idx):
+            i = _wrap_index(arr, idx)
+            return _decode_utf8(arr._values, arr._offsets[i],
+                                arr._offsets[i + 1])
+    else:
+        def impl(arr, idx):
+            return arr._values[_wrap_index(arr, idx)]
+    return impl
+
+
+@overload_method(types.ArrowArray, 'is_valid')
+def arrow_is_valid(arr, idx):
+    if isinstance(idx, types.Integer):
+        def impl(arr, idx):
+            # No validity bitmap means no nulls
+            if _is_null(arr._validity):
+                return True
+            i = _wrap_index(arr, idx)
+            return ((arr._validity[i >> 3] >> (i & 7)) & 1) == 1
+        return impl
+
+
+@overload_attribute(types.ArrowArray, 'validity')
+def arrow_validity(arr):
+    # The whole bitmap: bit `offset + i` is set if item `i` is valid
+    def get(arr):
+        if _is_null(arr._validity):
+            nbytes = 0
+        else:
+            nbytes = (arr.offset + arr._length + 7) >> 3
+        return _buffer_view(arr, arr._validity, 0, nbytes)
+    return get
+
+
+@overload_attribute(types.ArrowArray, 'values')
+def arrow_values(arr):
+    if arr.is_string:
+        # The character data, indexed by the offsets
+        def get(arr):
+            end = arr._offsets[arr.offset + arr._length]
+            return _buffer_view(arr, arr._values, 0, end)
+    else:
+        def get(arr):
+            return _buffer_view(arr, arr._values, arr.offset, arr._length)
+    return get
+
+
+@overload_attribute(types.ArrowArray, 'offsets')
+def arrow_offsets(arr):
+    if arr.is_string:
+        def get(arr):
+            return _buffer_view(arr, arr._offsets, arr.offset,
+                                arr._length + 1)
+        return get
@@ -1,5 +1,6 @@
 import sys
 import argparse
+import datetime
 import os
 import subprocess
 import json
@@ -27,10 +28,69 @@ def make_parser():
                         help='Output system information for bug reporting')
     parser.add_argument('--sys-json', nargs=1,
                         help='Saves the system info dict as a json file')
+    parser.add_argument('--cache-stats', nargs='?', const='', metavar='DIR',
+                        help='Output statistics about the cache directory '
+                             '(default: the user-wide or NUMBA_CACHE_DIR one)')
+    parser.add_argument('--cache-prune', nargs='?', const='', metavar='DIR',
+                        help='Remove the dead files of the cache directory, '
+                             'and its least recently used entries beyond '
+                             '--cache-max-size')
+    parser.add_argument('--cache-max-size', type=int, metavar='MB',
+                        help='Size the cache directory is pruned to '
+                             '(default: NUMBA_CACHE_MAX_SIZE)')
     parser.add_argument('filename', nargs='?', help='Python source filename')
     return parser
 
 
+def _get_cache_directory(path):
+    from numba.core import caching, config
+
+    if not path:
+        path = config.CACHE_DIR or caching.get_user_cache_dir()
+    return caching.CacheDirectory(path)
+
+
+def _format_size(nbytes):
+    return "%.1f MB" % (nbytes / (1 << 20))
+
+
+def _format_time(t):
+    if t is None:
+        return "-"
+    return datetime.datetime.fromtimestamp(t).strftime("%Y-%m-%d %H:%M:%S")
+
+
+def display_cache_stats(path):
+    cache_dir = _get_cache_directory(path)
+    stats = cache_dir.stats()
+    rows = [
+        ("Cache directory", cache_dir.path),
+        ("Functions", stats['functions']),
+        ("Overloads", stats['overloads']),
+        ("Total size", _format_size(stats['size'])),
+        ("Dead files", "%d (%s)" % (stats['dead_files'],
+                                    _format_size(stats['dead_size']))),
+        ("Other files", "%d (%s)" % (stats['other_files'],
+                                     _format_size(stats['other_size']))),
+        ("Oldest access", _format_time(stats['oldest_access'])),
+        ("Newest access", _format_time(stats['newest_access'])),
+    ]
+    for name, value in rows:
+        print("%-20s: %s" % (name, value))
+
+
+def prune_cache(path, max_size=None):
+    from numba.core import config
+
+    if max_size is None and config.CACHE_MAX_SIZE > 0:
+        max_size = config.CACHE_MAX_SIZE
+    cache_dir = _get_cache_directory(path)
+    nfiles, nbytes = cache_dir.prune(None if max_size is None
+                                     else max_size << 20)
+    print("Removed %d files (%s) from %s" % (nfiles, _format_size(nbytes),
+                                             cache_dir.path))
+
+
 def main():
     parser = make_parser()
     args = parser.parse_args()
@@ -55,6 +115,14 @@ def main():
             json.dump(info, f, indent=4)
         sys.exit(0)
 
+    if args.cache_stats is not None:
+        display_cache_stats(args.cache_stats)
+        sys.exit(0)
+
+    if args.cache_prune is not None:
+        prune_cache(args.cache_prune, args.cache_max_size)
+        sys.exit(0)
+
     os.environ['NUMBA_DUMP_ANNOTATION'] = str(int(args.annotate))
     if args.annotate_html is not None:
         try:
@@ -14,11 +14,12 @@ from llvmlite.llvmpy.core import Constant
 
 import numpy as np
 
-from numba import pndindex
+from numba import pndindex, generated_jit
 from numba.core import types, utils, typing, errors, cgutils, extending
 from numba.np.numpy_support import (as_dtype, carray, farray, is_contiguous,
                                     is_fortran)
-from numba.np.numpy_support import type_can_asarray, is_nonelike
+from numba.np.numpy_support import (type_can_asarray, is_nonelike,
+                                    as_dlpack_dtype)
 from numba.core.imputils import (lower_builtin, lower_getattr,
                                  lower_getattr_generic,
                                  lower_setattr_generic,
@@ -3406,6 +3407,8 @@ def _empty_nd_impl(context, builder, arrtype, shapes):
     # alloc_unsuppported allocator above.
     allocator_impl = _allocators.lookup(arrtype.__class__, alloc_unsupported)
     meminfo = allocator_impl(context, builder, size=allocsize, align=align)
+    cgutils.guard_memory_error(context, builder, meminfo,
+                               "cannot allocate array")
 
     data = context.nrt.meminfo_data(builder, meminfo)
 
@@ -4135,6 +4138,268 @@ def np_frombuffer(context, builder, sig, args):
     return impl_ret_borrowed(context, builder, sig.return_type, res)
 
 
+# np.memmap() and np.fromfile(): arrays mapping a file, see
+# NRT_MemInfo_new_mmap() in nrt.h.  The values are the NRT_MMAP_* modes.
+
+_memmap_modes = {
+    'r': 0, 'readonly': 0,
+    'r+': 1, 'readwrite': 1,
+    'c': 2, 'copyonwrite': 2,
+    'w+': 3, 'write': 3,
+}
+
+
+@intrinsic
+def _memmap_array(typingctx, filename, offset, shape, mode, dtype):
+    """
+    Map the file *filename* at *offset* into a new C-contiguous array of
+    the given *shape* and *dtype*.  If *shape* is None, a 1d array reaching
+    the end of the file is created.  *mode* is a literal np.memmap mode.
+    *filename* must be ASCII.
+    """
+    if (not isinstance(mode, types.StringLiteral) or
+            mode.literal_value not in _memmap_modes):
+        return
+    if not isinstance(dtype, types.DTypeSpec):
+        return
+    if isinstance(shape, types.NoneType):
+        ndim = 1
+    elif (isinstance(shape, types.BaseTuple) and
+          all(isinstance(s, types.Integer) for s in shape)):
+        ndim = len(shape)
+    else:
+        return
+    mode_flag = _memmap_modes[mode.literal_value]
+    retty = types.Array(dtype.dtype, ndim, 'C', readonly=mode_flag == 0)
+    sig = retty(types.unicode_type, types.intp, shape, mode, dtype)
+
+    def codegen(context, builder, sig, args):
+        filename, offset, shape = args[:3]
+        shapety = sig.args[2]
+        aryty = sig.return_type
+        intp_t = cgutils.intp_t
+
+        uni = cgutils.create_struct_proxy(types.unicode_type)(
+            context, builder, value=filename)
+        itemsize = get_itemsize(context, aryty)
+        ll_itemsize = intp_t(itemsize)
+
+        if isinstance(shapety, types.NoneType):
+            size_ptr = cgutils.alloca_once_value(builder, intp_t(-1))
+        else:
+            shapes = [context.cast(builder, s, ty, types.intp)
+                      for s, ty in zip(cgutils.unpack_tuple(builder, shape),
+                                       shapety)]
+            nbytes = ll_itemsize
+            overflow = cgutils.false_bit
+            for s in shapes:
+                is_neg = builder.icmp_signed('<', s, intp_t(0))
+                with cgutils.if_unlikely(builder, is_neg):
+                    context.call_conv.return_user_exc(
+                        builder, ValueError,
+                        ("negative dimensions not allowed",))
+                nbytes, ovf = cgutils.muladd_with_overflow(builder, nbytes,
+                                                           s, intp_t(0))
+                overflow = builder.or_(overflow, ovf)
+            with builder.if_then(overflow, likely=False):
+                context.call_conv.return_user_exc(
+                    builder, ValueError,
+                    ("array is too big; `arr.size * arr.dtype.itemsize` is "
+                     "larger than the maximum possible size.",))
+            size_ptr = cgutils.alloca_once_value(builder, nbytes)
+
+        meminfo = context.nrt.meminfo_new_mmap(builder, uni.data, uni.length,
+                                               offset, size_ptr, mode_flag)
+        with cgutils.if_unlikely(builder, cgutils.is_null(builder, meminfo)):
+            context.call_conv.return_user_exc(
+                builder, OSError, ("cannot memory-map file",))
+
+        if isinstance(shapety, types.NoneType):
+            size = builder.load(size_ptr)
+            rem = builder.urem(size, ll_itemsize)
+            with cgutils.if_unlikely(builder, cgutils.is_not_null(builder,
+                                                                  rem)):
+                context.nrt.decref(builder, types.MemInfoPointer(types.voidptr),
+                                   meminfo)
+                context.call_conv.return_user_exc(
+                    builder, ValueError,
+                    ("size of available data is not a multiple of the "
+                     "data-type size",))
+            shapes = [builder.udiv(size, ll_itemsize)]
+
+        strides = []
+        off = ll_itemsize
+        for s in reversed(shapes):
+            strides.append(off)
+            off = builder.mul(off, s)
+        strides.reverse()
+
+        ary = make_array(aryty)(context, builder)
+        data = context.nrt.meminfo_data(builder, meminfo)
+        populate_array(ary,
+                       data=builder.bitcast(data, ary.data.type),
+                       shape=shapes,
+                       strides=strides,
+                       itemsize=ll_itemsize,
+                       meminfo=meminfo)
+        return impl_ret_new_ref(context, builder, aryty, ary._getvalue())
+
+    return sig, codegen
+
+
+def _memmap_dtype(dtype):
+    if isinstance(dtype, types.DTypeSpec):
+        return True
+    try:
+        np.dtype(dtype)
+    except TypeError:
+        return False
+    return True
+
+
+@overload(np.memmap)
+def np_memmap(filename, dtype=np.uint8, mode='r+', offset=0, shape=None,
+              order='C'):
+    if not isinstance(filename, (types.UnicodeType, types.StringLiteral)):
+        return
+    if not _memmap_dtype(dtype):
+        return
+    if isinstance(mode, types.StringLiteral):
+        mode = mode.literal_value
+    if not isinstance(mode, str):
+        # mode must be a compile-time constant
+        return
+    if mode not in _memmap_modes:
+        raise errors.TypingError("mode must be one of %s"
+                                 % sorted(_memmap_modes))
+    if not isinstance(offset, (int, types.Integer)):
+        return
+    if isinstance(order, types.StringLiteral):
+        order = order.literal_value
+    if order != 'C':
+        raise errors.TypingError("only order='C' is supported")
+    if is_nonelike(shape):
+        if _memmap_modes[mode] == 3:
+            raise errors.TypingError("shape must be given in mode %r" % mode)
+
+        def impl(filename, dtype=np.uint8, mode='r+', offset=0, shape=None,
+                 order='C'):
+            if not filename.isascii():
+                raise ValueError("filename must be ASCII")
+            return _memmap_array(filename, offset, None, mode, dtype)
+    elif isinstance(shape, types.Integer):
+        def impl(filename, dtype=np.uint8, mode='r+', offset=0, shape=None,
+                 order='C'):
+            if not filename.isascii():
+                raise ValueError("filename must be ASCII")
+            return _memmap_array(filename, offset, (shape,), mode, dtype)
+    elif isinstance(shape, types.BaseTuple):
+        def impl(filename, dtype=np.uint8, mode='r+', offset=0, shape=None,
+                 order='C'):
+            if not filename.isascii():
+                raise ValueError("filename must be ASCII")
+            return _memmap_array(filename, offset, shape, mode, dtype)
+    else:
+        return
+    return impl
+
+
+@overload(np.fromfile)
+def np_fromfile(file, dtype=np.float64, count=-1, sep='', offset=0):
+    if not isinstance(file, (types.UnicodeType, types.StringLiteral)):
+        return
+    if not _memmap_dtype(dtype):
+        return
+    if not isinstance(count, (int, types.Integer)):
+        return
+    if isinstance(sep, types.StringLiteral):
+        sep = sep.literal_value
+    if sep != '':
+        raise errors.TypingError("only binary files (sep='') are supported")
+    if not isinstance(offset, (int, types.Integer)):
+        return
+
+    # A private mapping: the array can be written to without touching the
+    # file, and pages are only copied when modified.
+    def impl(file, dtype=np.float64, count=-1, sep='', offset=0):
+        if not file.isascii():
+            raise ValueError("file must be ASCII")
+        if count < 0:
+            return _memmap_array(file, offset, None, 'c', dtype)
+        return _memmap_array(file, offset, (count,), 'c', dtype)
+    return impl
+
+
+@intrinsic
+def _memmap_flush(typingctx, arr, sync):
+    if not isinstance(arr, types.Array):
+        return
+    sig = types.int32(arr, types.boolean)
+
+    def codegen(context, builder, sig, args):
+        ary = make_array(sig.args[0])(context, builder, value=args[0])
+        return context.nrt.meminfo_mmap_flush(builder, ary.meminfo, args[1])
+
+    return sig, codegen
+
+
+@generated_jit
+def memmap_flush(arr, sync=True):
+    """
+    Write the changes to an array created by np.memmap() in nopython mode
+    back to its file.  If *sync* is true, wait for the write to complete.
+    """
+    if not isinstance(arr, types.Array):
+        raise errors.TypingError("Input must be an array.")
+
+    def impl(arr, sync=True):
+        status = _memmap_flush(arr, sync)
+        if status > 0:
+            raise ValueError("array is not memory-mapped by Numba")
+        if status < 0:
+            raise OSError("cannot flush memory-mapped file")
+    return impl
+
+
+@intrinsic
+def _to_dlpack(typingctx, arr):
+    if not isinstance(arr, types.Array):
+        return
+    try:
+        as_dlpack_dtype(arr.dtype)
+    except NotImplementedError:
+        return
+    sig = types.DLPackCapsule(arr)(arr)
+
+    def codegen(context, builder, sig, args):
+        capsule = cgutils.create_struct_proxy(sig.return_type)(context,
+                                                               builder)
+        capsule.array = args[0]
+        return impl_ret_borrowed(context, builder, sig.return_type,
+                                 capsule._getvalue())
+
+    return sig, codegen
+
+
+@generated_jit
+def to_dlpack(arr):
+    """
+    Export an array as a DLPack capsule on the CPU device.  The capsule
+    keeps the array's memory alive until its consumer releases it.
+    """
+    if not isinstance(arr, types.Array):
+        raise errors.TypingError("Input must be an array.")
+    try:
+        as_dlpack_dtype(arr.dtype)
+    except NotImplementedError:
+        raise errors.TypingError("%s arrays cannot be exported through "
+                                 "DLPack" % (arr.dtype,))
+
+    def impl(arr):
+        return _to_dlpack(arr)
+    return impl
+
+
 @lower_builtin(carray, types.Any, types.Any)
 @lower_builtin(carray, types.Any, types.Any, types.DTypeSpec)
 @lower_builtin(farray, types.Any, types.Any)
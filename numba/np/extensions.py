@@ -3,8 +3,11 @@ NumPy extensions.
 """
 
 from numba.np.arraymath import cross2d
+from numba.np.arrayobj import memmap_flush, to_dlpack
 
 
 __all__ = [
-    'cross2d'
+    'cross2d',
+    'memmap_flush',
+    'to_dlpack',
 ]
@@ -208,6 +208,37 @@ def map_arrayscalar_type(val):
     return from_dtype(dtype)
 
 
+# DLDataTypeCode values from dlpack.h, and the matching dtype kinds
+_dlpack_kinds = {0: 'i', 1: 'u', 2: 'f', 5: 'c', 6: 'b'}
+
+
+def from_dlpack_dtype(code, bits):
+    """
+    Return the Numba type of the DLPack dtype with the given type *code*
+    and *bits*.
+    """
+    kind = _dlpack_kinds.get(code)
+    if kind is None or bits % 8 or (kind == 'b' and bits != 8):
+        raise NotImplementedError("unsupported DLPack dtype (%d, %d)"
+                                  % (code, bits))
+    return from_dtype(np.dtype('%s%d' % (kind, bits // 8)))
+
+
+def as_dlpack_dtype(nbtype):
+    """
+    Return the DLPack (type code, bits) of the Numba type *nbtype*.
+    """
+    if isinstance(nbtype, types.Boolean):
+        return 6, 8
+    if isinstance(nbtype, types.Integer):
+        return (0 if nbtype.signed else 1), nbtype.bitwidth
+    if isinstance(nbtype, types.Float):
+        return 2, nbtype.bitwidth
+    if isinstance(nbtype, types.Complex):
+        return 5, nbtype.bitwidth
+    raise NotImplementedError("%r has no DLPack equivalent" % (nbtype,))
+
+
 def is_array(val):
     return isinstance(val, np.ndarray)
 
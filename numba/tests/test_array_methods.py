@@ -1,16 +1,20 @@
 from itertools import product, cycle, permutations
+import os
 import sys
 import warnings
 
 import numpy as np
 
-from numba import jit, typeof
+from numba import jit, njit, typeof
 from numba.core import types
 from numba.core.compiler import compile_isolated
 from numba.core.errors import TypingError, LoweringError
+from numba.core.runtime import rtsys
+from numba.np.extensions import memmap_flush
 from numba.np.numpy_support import as_dtype
 from numba.tests.support import (TestCase, CompilationCache, MemoryLeak,
-                                 MemoryLeakMixin, tag, needs_blas)
+                                 MemoryLeakMixin, tag, needs_blas,
+                                 temp_directory)
 import unittest
 
 TIMEDELTA_M = 'timedelta64[M]'
@@ -1385,5 +1389,144 @@ class TestArrayComparisons(TestCase):
     # Other comparison operators ('==', etc.) are tested in test_ufuncs
 
 
+@unittest.skipIf(sys.platform.startswith('win'),
+                 "file mapping is not supported on Windows")
+class TestArrayMemmap(MemoryLeakMixin, TestCase):
+    """
+    Test np.memmap() and np.fromfile() in nopython mode.
+    """
+
+    def setUp(self):
+        super(TestArrayMemmap, self).setUp()
+        self.tempdir = temp_directory('test_array_memmap')
+
+    def make_file(self, name, arr):
+        path = os.path.join(self.tempdir, name)
+        arr.tofile(path)
+        return path
+
+    def test_memmap_read(self):
+        @njit
+        def mapsum(path, offset):
+            a = np.memmap(path, dtype=np.int32, mode='r', offset=offset)
+            return a.sum(), a.size
+
+        arr = np.arange(1000, dtype=np.int32)
+        path = self.make_file('read.bin', arr)
+        self.assertEqual(mapsum(path, 0), (arr.sum(), 1000))
+        self.assertEqual(mapsum(path, 4 * 123), (arr[123:].sum(), 877))
+
+    def test_memmap_memory_usage(self):
+        # Mapped files don't count toward the NRT memory statistics or limit
+        @njit
+        def mapit(path):
+            return np.memmap(path, dtype=np.int32, mode='r')
+
+        arr = np.arange(10 ** 5, dtype=np.int32)
+        path = self.make_file('usage.bin', arr)
+        mapit(path)
+        before = rtsys.get_memory_usage()
+        rtsys.set_memory_limit(before + 1000)
+        try:
+            got = mapit(path)
+            self.assertEqual(rtsys.get_memory_usage(), before)
+        finally:
+            rtsys.set_memory_limit(0)
+        np.testing.assert_equal(got, arr)
+        del got
+        self.assertEqual(rtsys.get_memory_usage(), before)
+
+    def test_memmap_shape(self):
+        @njit
+        def get(path):
+            return np.memmap(path, dtype=np.float64, mode='r',
+                             shape=(10, 20))
+
+        arr = np.random.random((20, 20))
+        path = self.make_file('shape.bin', arr)
+        got = get(path)
+        self.assertFalse(got.flags.writeable)
+        np.testing.assert_equal(got, arr[:10])
+        self.assertEqual(typeof(got).layout, 'C')
+
+    def test_memmap_write(self):
+        @njit
+        def fill(path, n):
+            a = np.memmap(path, dtype=np.int64, mode='w+', shape=n)
+            for i in range(n):
+                a[i] = i * i
+            memmap_flush(a)
+
+        @njit
+        def update(path):
+            a = np.memmap(path, dtype=np.int64, mode='r+')
+            a[0] = -1
+            memmap_flush(a, False)
+
+        path = os.path.join(self.tempdir, 'write.bin')
+        fill(path, 100)
+        expected = np.arange(100, dtype=np.int64) ** 2
+        np.testing.assert_equal(np.fromfile(path, dtype=np.int64), expected)
+        update(path)
+        expected[0] = -1
+        np.testing.assert_equal(np.fromfile(path, dtype=np.int64), expected)
+
+    def test_fromfile(self):
+        @njit
+        def load(path):
+            a = np.fromfile(path, dtype=np.int16)
+            a[:] += 1
+            return a
+
+        @njit
+        def load_count(path, count, offset):
+            return np.fromfile(path, np.int16, count, offset=offset)
+
+        arr = np.arange(500, dtype=np.int16)
+        path = self.make_file('fromfile.bin', arr)
+        np.testing.assert_equal(load(path), arr + 1)
+        # The file is not modified
+        np.testing.assert_equal(np.fromfile(path, dtype=np.int16), arr)
+        np.testing.assert_equal(load_count(path, 10, 20), arr[10:20])
+
+    def test_errors(self):
+        @njit
+        def get(path):
+            return np.memmap(path, dtype=np.int32, mode='r', shape=100)
+
+        @njit
+        def get_all(path):
+            return np.memmap(path, dtype=np.int32, mode='r')
+
+        @njit
+        def get_shape(path, shape):
+            return np.memmap(path, dtype=np.int32, mode='r', shape=shape)
+
+        @njit
+        def flush(a):
+            memmap_flush(a)
+
+        with self.assertRaises(OSError):
+            get(os.path.join(self.tempdir, 'nonexistent.bin'))
+        path = self.make_file('small.bin', np.arange(10, dtype=np.int32))
+        # Not enough data
+        with self.assertRaises(OSError):
+            get(path)
+        path = self.make_file('odd.bin', np.arange(5, dtype=np.int8))
+        with self.assertRaises(ValueError) as raises:
+            get_all(path)
+        self.assertIn("not a multiple", str(raises.exception))
+        with self.assertRaises(ValueError) as raises:
+            get_shape(path, (1 << 40, 1 << 40))
+        self.assertIn("array is too big", str(raises.exception))
+        with self.assertRaises(ValueError) as raises:
+            flush(np.zeros(3))
+        self.assertIn("not memory-mapped", str(raises.exception))
+
+        with self.assertRaises(TypingError) as raises:
+            njit(lambda p: np.memmap(p, mode='w+'))(path)
+        self.assertIn("shape must be given", str(raises.exception))
+
+
 if __name__ == '__main__':
     unittest.main()
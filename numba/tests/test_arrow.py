@@ -0,0 +1,262 @@
+import ctypes
+
+import numpy as np
+
+from numba import njit, typeof
+from numba.core import types
+from numba.tests.support import TestCase, MemoryLeakMixin
+import unittest
+
+try:
+    import pyarrow as pa
+except ImportError:
+    pa = None
+else:
+    if not hasattr(pa.Array, '__arrow_c_array__'):
+        pa = None
+
+
+ArrowSchemaRelease = ctypes.CFUNCTYPE(None, ctypes.c_void_p)
+ArrowArrayRelease = ctypes.CFUNCTYPE(None, ctypes.c_void_p)
+
+
+class ArrowSchema(ctypes.Structure):
+    _fields_ = [('format', ctypes.c_char_p),
+                ('name', ctypes.c_char_p),
+                ('metadata', ctypes.c_char_p),
+                ('flags', ctypes.c_int64),
+                ('n_children', ctypes.c_int64),
+                ('children', ctypes.c_void_p),
+                ('dictionary', ctypes.c_void_p),
+                ('release', ArrowSchemaRelease),
+                ('private_data', ctypes.c_void_p)]
+
+
+class ArrowArray(ctypes.Structure):
+    _fields_ = [('length', ctypes.c_int64),
+                ('null_count', ctypes.c_int64),
+                ('offset', ctypes.c_int64),
+                ('n_buffers', ctypes.c_int64),
+                ('n_children', ctypes.c_int64),
+                ('buffers', ctypes.POINTER(ctypes.c_void_p)),
+                ('children', ctypes.c_void_p),
+                ('dictionary', ctypes.c_void_p),
+                ('release', ArrowArrayRelease),
+                ('private_data', ctypes.c_void_p)]
+
+
+class CtypesArrowArray(object):
+    """
+    An object exporting hand-built Arrow C Data Interface structures, so
+    that the C paths are exercised without pyarrow.  *buffers* are NumPy
+    arrays or None.  Counts the exports and the array releases.
+    """
+
+    def __init__(self, fmt, length, buffers, null_count=0, offset=0):
+        self.format = fmt.encode()
+        self.length = length
+        self.buffers = buffers
+        self.null_count = null_count
+        self.offset = offset
+        self.exports = 0
+        self.released = 0
+        self._live = []
+        self._release_schema = ArrowSchemaRelease(lambda ptr: None)
+        self._release_array = ArrowArrayRelease(self._release)
+
+    def _release(self, ptr):
+        self.released += 1
+
+    def __arrow_c_array__(self, requested_schema=None):
+        schema = ArrowSchema()
+        schema.format = self.format
+        schema.release = self._release_schema
+        array = ArrowArray()
+        array.length = self.length
+        array.null_count = self.null_count
+        array.offset = self.offset
+        array.n_buffers = len(self.buffers)
+        buffers = (ctypes.c_void_p * len(self.buffers))(
+            *[b.ctypes.data if b is not None else None
+              for b in self.buffers])
+        array.buffers = buffers
+        array.release = self._release_array
+        self._live.append((schema, array, buffers))
+        self.exports += 1
+        capsule_new = ctypes.pythonapi.PyCapsule_New
+        capsule_new.restype = ctypes.py_object
+        capsule_new.argtypes = [ctypes.c_void_p, ctypes.c_char_p,
+                                ctypes.c_void_p]
+        return (capsule_new(ctypes.addressof(schema), b"arrow_schema", None),
+                capsule_new(ctypes.addressof(array), b"arrow_array", None))
+
+
+@njit
+def getitem(arr, i):
+    return arr[i]
+
+
+@njit
+def total(arr):
+    s = 0
+    for i in range(len(arr)):
+        if arr.is_valid(i):
+            s += arr[i]
+    return s
+
+
+@njit
+def items(arr):
+    return [arr[i] for i in range(len(arr)) if arr.is_valid(i)]
+
+
+class TestCtypesArrowArray(MemoryLeakMixin, TestCase):
+    """
+    Test the Arrow C Data Interface with hand-built arrays.
+    """
+
+    def int32_array(self):
+        # [1, 2, None, 4, 5]
+        values = np.array([1, 2, 0, 4, 5], dtype=np.int32)
+        validity = np.array([0x1b], dtype=np.uint8)
+        return CtypesArrowArray('i', 5, [validity, values], null_count=1)
+
+    def test_typeof(self):
+        self.assertEqual(typeof(self.int32_array()),
+                         types.ArrowArray(types.int32, 'i'))
+        arr = CtypesArrowArray('U', 0, [None, np.zeros(1, np.int64),
+                                        np.zeros(0, np.uint8)])
+        self.assertEqual(typeof(arr),
+                         types.ArrowArray(types.unicode_type, 'U'))
+
+    def test_primitive(self):
+        arr = self.int32_array()
+        self.assertEqual(total(arr), 12)
+        # The same export is used for typing and unboxing, and it is
+        # released with the native array
+        self.assertEqual(arr.exports, 1)
+        self.assertEqual(arr.released, 1)
+        self.assertEqual(getitem(arr, -1), 5)
+        self.assertEqual(arr.exports, 2)
+        self.assertEqual(arr.released, 2)
+
+    def test_offset(self):
+        values = np.arange(6, dtype=np.float64)
+        # [0, None, 2, 3, None, 5][1:5]
+        validity = np.array([0x2d], dtype=np.uint8)
+        arr = CtypesArrowArray('g', 4, [validity, values], null_count=2,
+                               offset=1)
+        self.assertEqual(total(arr), 5.0)
+        self.assertEqual(getitem(arr, 1), 2.0)
+
+    def test_strings(self):
+        # ['a', None, 'caf\xe9', '']
+        data = np.frombuffer('acaf\xe9'.encode('utf-8'), dtype=np.uint8)
+        offsets = np.array([0, 1, 1, 6, 6], dtype=np.int32)
+        validity = np.array([0x0d], dtype=np.uint8)
+        arr = CtypesArrowArray('u', 4, [validity, offsets, data],
+                               null_count=1)
+        self.assertEqual(list(items(arr)), ['a', 'caf\xe9', ''])
+
+    def test_box(self):
+        @njit
+        def ident(arr):
+            return arr
+
+        arr = self.int32_array()
+        self.assertIs(ident(arr), arr)
+        self.assertEqual(arr.released, 1)
+
+    def test_bad_layout(self):
+        arr = CtypesArrowArray('i', 1, [None])
+        with self.assertRaises(TypeError) as raises:
+            total(arr)
+        self.assertIn("unexpected Arrow array layout", str(raises.exception))
+
+
+@unittest.skipIf(pa is None, "pyarrow with Arrow C Data Interface needed")
+class TestArrowArray(MemoryLeakMixin, TestCase):
+    """
+    Test arrays exported through the Arrow C Data Interface.
+    """
+
+    def test_typeof(self):
+        cases = [(pa.int8(), types.int8, 'c'),
+                 (pa.uint32(), types.uint32, 'I'),
+                 (pa.int64(), types.int64, 'l'),
+                 (pa.float64(), types.float64, 'g'),
+                 (pa.string(), types.unicode_type, 'u'),
+                 (pa.large_string(), types.unicode_type, 'U')]
+        for arrow_type, dtype, fmt in cases:
+            arr = pa.array([], type=arrow_type)
+            self.assertEqual(typeof(arr), types.ArrowArray(dtype, fmt))
+
+    def test_primitive(self):
+        arr = pa.array([1, 2, None, 4, 5], type=pa.int32())
+        self.assertEqual(getitem(arr, 1), 2)
+        self.assertEqual(getitem(arr, -1), 5)
+        self.assertEqual(total(arr), 12)
+        self.assertEqual(total(pa.array([1.5, 2.5])), 4.0)
+
+    def test_slice(self):
+        arr = pa.array([1, None, 3, 4, None, 6], type=pa.int64())[1:5]
+        self.assertEqual(getitem(arr, 0), getitem(arr, -4))
+        self.assertEqual(total(arr), 7)
+
+        @njit
+        def info(arr):
+            return len(arr), arr.offset, arr.null_count
+
+        self.assertEqual(info(arr), (4, 1, 2))
+
+    def test_strings(self):
+        data = ['a', None, 'caf\xe9', '', '€', '\U0001f600x', 'abc']
+        for arrow_type in (pa.string(), pa.large_string()):
+            arr = pa.array(data, type=arrow_type)
+            self.assertEqual(list(items(arr)),
+                             [s for s in data if s is not None])
+            self.assertEqual(list(items(arr[2:6])), data[2:6])
+
+    def test_buffers(self):
+        @njit
+        def buffers(arr):
+            return arr.values, arr.validity
+
+        arr = pa.array([1, None, 3], type=pa.int16())
+        values, validity = buffers(arr)
+        self.assertEqual(values.dtype, np.int16)
+        self.assertFalse(values.flags.writeable)
+        self.assertEqual(values[0], 1)
+        self.assertEqual(values[2], 3)
+        self.assertEqual(validity[0] & 0x7, 0x5)
+        # The views keep the Arrow array alive
+        del arr
+        self.assertEqual(values[2], 3)
+
+        # No validity bitmap without nulls
+        values, validity = buffers(pa.array([1.0, 2.0]))
+        self.assertEqual(len(validity), 0)
+        np.testing.assert_equal(values, [1.0, 2.0])
+
+    def test_string_buffers(self):
+        @njit
+        def buffers(arr):
+            return arr.values, arr.offsets
+
+        arr = pa.array(['ab', 'c', 'def'])[1:]
+        values, offsets = buffers(arr)
+        np.testing.assert_equal(offsets, [2, 3, 6])
+        self.assertEqual(bytes(values[offsets[0]:offsets[-1]]), b'cdef')
+
+    def test_box(self):
+        @njit
+        def ident(arr):
+            return arr
+
+        arr = pa.array([1, 2, 3])
+        self.assertIs(ident(arr), arr)
+
+    def test_unsupported(self):
+        arr = pa.array([True, False])
+        with self.assertRaises(ValueError):
+            typeof(arr)
@@ -101,6 +101,22 @@ class TestCLi(TestCase):
                     with self.subTest(k=k):
                         self.assertIsInstance(info[k], t)
 
+    def test_cache_stats_and_prune(self):
+        with TemporaryDirectory() as d:
+            dead = os.path.join(d, "mod.func-1.py38.1.nbc")
+            with open(dead, "wb") as f:
+                f.write(b"dead")
+            cmdline = [sys.executable, "-m", "numba", "--cache-stats", d]
+            o, _ = run_cmd(cmdline)
+            self.assertIn("Cache directory", o)
+            self.assertIn("Dead files          : 1", o)
+
+            cmdline = [sys.executable, "-m", "numba", "--cache-prune", d,
+                       "--cache-max-size", "100"]
+            o, _ = run_cmd(cmdline)
+            self.assertIn("Removed 1 files", o)
+            self.assertFalse(os.path.exists(dead))
+
 
 if __name__ == '__main__':
     unittest.main()
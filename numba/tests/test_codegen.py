@@ -9,11 +9,14 @@ import ctypes
 import pickle
 import subprocess
 import sys
+import threading
 import weakref
 
 import llvmlite.binding as ll
+import llvmlite.ir as llvmir
 
 import unittest
+from unittest import mock
 from numba.core.codegen import JITCPUCodegen
 from numba.core.compiler_lock import global_compiler_lock
 from numba.tests.support import TestCase
@@ -188,6 +191,76 @@ class JITCPUCodegenTestCase(TestCase):
         self.assertIn("Inspection disabled", str(w[0].message))
         self.assertIn("sum", str(raises.exception))
 
+    def _add_ir_modules(self, library, count):
+        # Add *count* IR modules defining add<i>(), and one defining sum()
+        # calling them all
+        i32 = llvmir.IntType(32)
+        fnty = llvmir.FunctionType(i32, [i32, i32])
+        names = ['add%d' % i for i in range(count)]
+        for i, name in enumerate(names):
+            mod = library.create_ir_module(name)
+            fn = llvmir.Function(mod, fnty, name)
+            builder = llvmir.IRBuilder(fn.append_basic_block())
+            a, b = fn.args
+            builder.ret(builder.add(builder.add(a, b), i32(i)))
+            library.add_ir_module(mod)
+
+        mod = library.create_ir_module('sum')
+        fn = llvmir.Function(mod, fnty, 'sum')
+        builder = llvmir.IRBuilder(fn.append_basic_block())
+        total = i32(0)
+        for name in names:
+            callee = llvmir.Function(mod, fnty, name)
+            total = builder.add(total, builder.call(callee, fn.args))
+        builder.ret(total)
+        library.add_ir_module(mod)
+
+    @unittest.skipUnless(hasattr(ll, 'create_context'),
+                         "needs llvmlite with LLVM contexts")
+    def test_deferred_optimization(self):
+        # The IR modules are optimized when the library is finalized, with
+        # the compiler lock released, so another thread can take it
+        library = self.codegen.create_library('deferred')
+        self._add_ir_modules(library, 8)
+        self.assertEqual(len(library._pending_modules), 9)
+
+        overlapped = []
+        orig = library._optimize_functions
+
+        def take_lock():
+            with global_compiler_lock:
+                pass
+
+        def optimize_functions(ll_module):
+            t = threading.Thread(target=take_lock)
+            t.start()
+            t.join(timeout=60)
+            overlapped.append(not t.is_alive())
+            return orig(ll_module)
+
+        with mock.patch.object(library, '_optimize_functions',
+                               optimize_functions):
+            ptr = library.get_pointer_to_function("sum")
+        self.assertEqual(overlapped, [True] * 9)
+        self.assertEqual(library._pending_modules, [])
+        cfunc = ctypes_sum_ty(ptr)
+        self.assertEqual(cfunc(2, 3), 8 * 5 + sum(range(8)))
+
+    def test_get_function_before_finalize(self):
+        # Functions of the modules added can be looked up and modified
+        # before the library is finalized
+        library = self.codegen.create_library('unfinalized')
+        self._add_ir_modules(library, 2)
+        fn = library.get_function('add1')
+        self.assertFalse(fn.is_declaration)
+        fn.linkage = 'linkonce_odr'
+        self.assertIn('define linkonce_odr i32 @add1',
+                      library.get_llvm_str())
+        self.assertEqual(library._pending_modules, [])
+        ptr = library.get_pointer_to_function("sum")
+        cfunc = ctypes_sum_ty(ptr)
+        self.assertEqual(cfunc(2, 3), 2 * 5 + 1)
+
     # Lifetime tests
 
     @unittest.expectedFailure  # MCJIT removeModule leaks and it is disabled
@@ -18,6 +18,45 @@ class TestCompilerLock(TestCase):
 
         func()
 
+    def test_gcl_released(self):
+        with global_compiler_lock:
+            with global_compiler_lock.released():
+                self.assertFalse(global_compiler_lock.is_locked())
+                self.assertEqual(global_compiler_lock.depth, 0)
+            require_global_compiler_lock()
+            # Not released when held recursively
+            with global_compiler_lock:
+                with global_compiler_lock.released():
+                    require_global_compiler_lock()
+                self.assertEqual(global_compiler_lock.depth, 2)
+        self.assertEqual(global_compiler_lock.depth, 0)
+
+    def test_gcl_released_in_compilation(self):
+        with global_compiler_lock.compilation():
+            with global_compiler_lock, global_compiler_lock.pipeline():
+                # All the levels held by a top-level compilation are
+                # released
+                with global_compiler_lock.released():
+                    self.assertFalse(global_compiler_lock.is_locked())
+                    self.assertEqual(global_compiler_lock.depth, 0)
+                self.assertEqual(global_compiler_lock.depth, 2)
+                # Not in nested compilations
+                with global_compiler_lock.pipeline():
+                    with global_compiler_lock.released():
+                        require_global_compiler_lock()
+                with global_compiler_lock.compilation():
+                    with global_compiler_lock.released():
+                        require_global_compiler_lock()
+                with global_compiler_lock.released():
+                    self.assertFalse(global_compiler_lock.is_locked())
+        self.assertEqual(global_compiler_lock.depth, 0)
+        # Nor in compilations started with the lock held
+        with global_compiler_lock:
+            with global_compiler_lock.compilation():
+                with global_compiler_lock.released():
+                    require_global_compiler_lock()
+        self.assertFalse(global_compiler_lock.is_locked())
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -1040,6 +1040,52 @@ class TestTypedDict(MemoryLeakMixin, TestCase):
     def test_str(self):
         self.check_stringify(str)
 
+    def test_empty_presized(self):
+        d = Dict.empty(types.int64, types.float64, n_keys=1000)
+        self.assertEqual(len(d), 0)
+        for i in range(1000):
+            d[i] = i / 2
+        self.assertEqual(len(d), 1000)
+        self.assertEqual(d[999], 499.5)
+
+        @njit
+        def foo(n):
+            d = Dict.empty(types.int64, types.int64, n_keys=n)
+            for i in range(n):
+                d[i] = -i
+            return d
+
+        self.assertEqual(dict(foo(100)), {i: -i for i in range(100)})
+        with self.assertRaises(RuntimeError):
+            foo(-1)
+
+    def test_from_arrays(self):
+        keys = np.arange(1000, dtype=np.int32) * 3
+        values = np.linspace(0, 1, 1000)
+        d = Dict.from_arrays(keys, values)
+        self.assertEqual(typeof(d), types.DictType(types.int32, types.float64))
+        self.assertEqual(dict(d), dict(zip(keys, values)))
+        # Later keys win
+        d = Dict.from_arrays(np.array([1, 2, 1]), np.array([1, 2, 3]))
+        self.assertEqual(dict(d), {1: 3, 2: 2})
+
+        @njit
+        def foo(keys, values):
+            return Dict.from_arrays(keys, values)
+
+        self.assertEqual(dict(foo(keys[::2], values[::2])),
+                         dict(zip(keys[::2], values[::2])))
+        with self.assertRaises(ValueError) as raises:
+            Dict.from_arrays(keys, values[:10])
+        self.assertIn("keys and values must have the same length",
+                      str(raises.exception))
+
+    def test_from_arrays_bad_args(self):
+        with self.assertRaises(TypingError) as raises:
+            Dict.from_arrays(np.zeros((2, 2)), np.zeros(4))
+        self.assertIn("from_arrays() expects two 1D arrays",
+                      str(raises.exception))
+
 
 class TestDictRefctTypes(MemoryLeakMixin, TestCase):
 
@@ -16,21 +16,24 @@ from io import StringIO
 import numpy as np
 
 from numba import njit, jit, generated_jit, typeof
-from numba.core import types, errors, codegen
+from numba.core import types, errors, codegen, utils, manifest
 from numba import _dispatcher
 from numba.core.compiler import compile_isolated
 from numba.core.errors import NumbaWarning
 from numba.tests.support import (TestCase, temp_directory, import_dynamic,
-                                 override_env_config, capture_cache_log,
-                                 captured_stdout)
+                                 override_config, override_env_config,
+                                 capture_cache_log, captured_stdout)
 from numba.np.numpy_support import as_dtype
-from numba.core.caching import _UserWideCacheLocator
+from numba.core.caching import (_UserWideCacheLocator, CacheDirectory,
+                                 _PackedStore, _FunctionHasher,
+                                 IndexDataCacheFile)
 from numba.core.dispatcher import Dispatcher
 from numba.tests.support import (skip_parfors_unsupported, needs_lapack,
                                  SerialMixin)
 
 import llvmlite.binding as ll
 import unittest
+from unittest import mock
 from numba.parfors import parfor
 
 try:
@@ -66,6 +69,11 @@ def star_defaults(x, y=2, *z):
     return x, y, z
 
 
+@jit(nopython=True)
+def manifest_usecase(x, y):
+    return x + y
+
+
 def generated_usecase(x, y=5):
     if isinstance(x, types.Complex):
         def impl(x, y):
@@ -207,6 +215,217 @@ class TestDispatcher(BaseTest):
             # Implicit conversion of complex to int disallowed
             c_add(12.3, 45.6j)
 
+    def test_resolution_cache(self):
+        c_add = jit(nopython=True)(add)
+        c_add(1, 2)
+        before = c_add.resolution_stats
+        for i in range(5):
+            self.assertPreciseEqual(c_add(i, 2), i + 2)
+        stats = c_add.resolution_stats
+        # The first resolution is cached and reused
+        self.assertEqual(stats.misses - before.misses, 1)
+        self.assertEqual(stats.hits - before.hits, 4)
+        self.assertEqual(stats.size, 1)
+        self.assertGreater(stats.hit_rate, 0.5)
+
+        # Adding an overload flushes the cache, and the new one is found
+        self.assertPreciseEqual(c_add(1.5, 2.5), 4.0)
+        self.assertEqual(c_add.resolution_stats.size, 0)
+        self.assertPreciseEqual(c_add(1.5, 2.5), 4.0)
+        self.assertPreciseEqual(c_add(1, 2), 3)
+        self.assertEqual(c_add.resolution_stats.size, 2)
+
+        c_add._reset_overloads()
+        self.assertEqual(c_add.resolution_stats.size, 0)
+
+    @unittest.skipIf(utils.PYVERSION < (3, 8), "vectorcall needs Python 3.8")
+    def test_vectorcall(self):
+        Py_TPFLAGS_HAVE_VECTORCALL = 1 << 11
+        c_add = jit(nopython=True)(addsub_defaults)
+        self.assertTrue(type(c_add).__flags__ & Py_TPFLAGS_HAVE_VECTORCALL)
+        # Positional calls (with and without defaults) go through the
+        # vectorcall fast path, the others through the generic one.
+        self.assertPreciseEqual(c_add(5, 3, 1), 3)
+        self.assertPreciseEqual(c_add(5, 3), 5)
+        self.assertPreciseEqual(c_add(5), 6)
+        self.assertPreciseEqual(c_add(5, z=1), 4)
+        self.assertPreciseEqual(c_add(*(5, 3), **{'z': 1}), 3)
+        self.assertPreciseEqual(type(c_add).__call__(c_add, 5, 3), 5)
+        self.assertEqual(len(c_add.overloads), 4)
+        with self.assertRaises(TypeError) as cm:
+            c_add()
+        self.assertIn("not enough arguments", str(cm.exception))
+        with self.assertRaises(TypeError) as cm:
+            c_add(1, 2, 3, 4)
+        self.assertIn("too many arguments", str(cm.exception))
+
+    def test_typeof_fast_paths(self):
+        # These arguments are typed without calling typeof_pyval()
+        from numba.typed import List, Dict
+        from numba.experimental import jitclass
+
+        @jitclass([('x', types.int64)])
+        class Point(object):
+            def __init__(self, x):
+                self.x = x
+
+        @jit(nopython=True)
+        def first(x, *args):
+            return x
+
+        args = ['abc', List([1, 2]), Dict.empty(types.int64, types.int64),
+                Point(1), ('abc', List([1.5]))]
+        for arg in args:
+            first(arg, 1)
+
+        def typeof_pyval(val):
+            raise AssertionError("typeof_pyval(%r) called" % (val,))
+
+        first.typeof_pyval = typeof_pyval
+        nsigs = len(first.signatures)
+        for arg in args:
+            first(arg, 1)
+        self.assertEqual(first('de', 1), 'de')
+        self.assertEqual(len(first.signatures), nsigs)
+
+    def test_call_stats(self):
+        c_add = jit(nopython=True)(add)
+        c_add(1, 2)
+        # Disabled by default
+        self.assertEqual(c_add.call_stats(), {})
+
+        c_add.enable_call_stats()
+        c_add(1.5, 2.5)
+        for i in range(10):
+            c_add(i, 2)
+        c_add(0.5, 2.5)
+        stats = c_add.call_stats()
+        self.assertEqual(set(stats), {(types.intp, types.intp),
+                                      (types.float64, types.float64)})
+        st = stats[types.intp, types.intp]
+        self.assertEqual(st.calls, 10)
+        self.assertGreater(st.total_time, 0)
+        self.assertEqual(sum(n for lo, hi, n in st.histogram), 10)
+        for lo, hi, n in st.histogram:
+            self.assertLess(lo, hi)
+        self.assertAlmostEqual(st.mean_time, st.total_time / 10)
+        # The call which compiled isn't counted
+        self.assertEqual(stats[types.float64, types.float64].calls, 1)
+
+        c_add.enable_call_stats(False)
+        c_add(1, 2)
+        self.assertEqual(c_add.call_stats()[types.intp, types.intp].calls,
+                         10)
+        c_add.reset_call_stats()
+        self.assertEqual(c_add.call_stats(), {})
+
+    def test_concurrent_compile(self):
+        # Threads calling a function with the same new argument types
+        # compile it once, and aren't seen as recursive calls
+        c_add = jit(nopython=True)(add)
+        barrier = threading.Barrier(4)
+        results = []
+
+        def run():
+            barrier.wait()
+            results.append(c_add(1, 2))
+
+        threads = [threading.Thread(target=run) for i in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual(results, [3] * 4)
+        self.assertEqual(len(c_add.overloads), 1)
+
+    @unittest.skipUnless(hasattr(ll, 'create_context'),
+                         "needs llvmlite with LLVM contexts")
+    def test_concurrent_cold_compile(self):
+        # The compiler lock is released while the IR modules of a library
+        # are optimized, so another thread can compile meanwhile
+        def slow(x):
+            return x + 1
+
+        def fast(x):
+            return x - 1
+
+        c_slow = jit(nopython=True)(slow)
+        c_fast = jit(nopython=True)(fast)
+        overlapped = []
+        orig = codegen.CodeLibrary._optimize_functions
+
+        def optimize_functions(library, ll_module):
+            if 'slow' in ll_module.name and not overlapped:
+                t = threading.Thread(target=c_fast, args=(1,))
+                t.start()
+                t.join(timeout=60)
+                overlapped.append(not t.is_alive())
+            return orig(library, ll_module)
+
+        with mock.patch.object(codegen.CodeLibrary, '_optimize_functions',
+                               optimize_functions):
+            self.assertEqual(c_slow(1), 2)
+        self.assertEqual(overlapped, [True])
+        self.assertEqual(c_fast(1), 0)
+        self.assertEqual(len(c_fast.overloads), 1)
+
+    def test_background_compile(self):
+        from numba.core.compiler_lock import global_compiler_lock
+
+        c_add = jit(nopython=True, background=True)(addsub_defaults)
+        # Holding the compiler lock keeps the background thread waiting
+        with global_compiler_lock:
+            self.assertPreciseEqual(c_add(1), 1 - 2 + 3)
+            self.assertPreciseEqual(c_add(1, z=4), 1 - 2 + 4)
+            self.assertEqual(c_add.signatures, [])
+        self.assertTrue(c_add.wait_background_compile())
+        self.assertEqual(len(c_add.signatures), 2)
+        self.assertPreciseEqual(c_add(1, z=4), 1 - 2 + 4)
+
+        # Arguments convertible to an existing specialization use it
+        with global_compiler_lock:
+            self.assertPreciseEqual(c_add(np.int8(1)), 1 - 2 + 3)
+            self.assertEqual(len(c_add.signatures), 2)
+        c_add.wait_background_compile()
+        self.assertEqual(len(c_add.signatures), 3)
+
+        # Stararg functions are called with the right arguments
+        @jit(nopython=True, background=True)
+        def total(x, *args):
+            return x + len(args)
+
+        self.assertPreciseEqual(total(1, 2, 3), 3)
+        total.wait_background_compile()
+        self.assertPreciseEqual(total(1, 2, 3), 3)
+
+        # Compilation errors are raised by the next call
+        @jit(nopython=True, background=True)
+        def bad(x):
+            return object()
+
+        self.assertIsInstance(bad(1), object)
+        bad.wait_background_compile()
+        with self.assertRaises(errors.TypingError):
+            bad(1)
+
+    def test_fingerprint_cache(self):
+        # Short (inline), long and very long (heap-allocated while being
+        # written) fingerprints of tuples of arrays resolve consistently
+        @jit(nopython=True)
+        def count(tup):
+            return len(tup)
+
+        arrays = [np.zeros(3, dtype=dt) for dt in ('i4', 'f8', 'c16')]
+        args = [tuple(arrays[:1]), tuple(arrays) * 3, tuple(arrays) * 30]
+        args += [tuple(a[::2] for a in arg) for arg in args]
+        for arg in args:
+            self.assertEqual(count(arg), len(arg))
+        nsigs = len(count.signatures)
+        self.assertEqual(nsigs, len(args))
+        for arg in args:
+            self.assertEqual(count(arg), len(arg))
+        self.assertEqual(len(count.signatures), nsigs)
+
     def test_ambiguous_new_version(self):
         """Test compiling new version in an ambiguous case
         """
@@ -647,6 +866,35 @@ class TestSignatureHandling(BaseTest):
             f(3, 4, y=6)
         self.assertIn("missing argument 'z'", str(cm.exception))
 
+    def test_named_args_not_interned(self):
+        """
+        Test named arguments whose names are built at runtime.
+        """
+        def pyfunc(alpha, beta=2, gamma=3):
+            return alpha - beta + gamma
+
+        f, check = self.compile_func(pyfunc)
+        kws = {''.join(['gam', 'ma']): 5, ''.join(['be', 'ta']): 7}
+        check(3, **kws)
+        check(**dict(kws, alpha=3))
+        self.assertEqual(len(f.overloads), 1)
+
+    def test_init_error_defargs(self):
+        """
+        Test that a failed initialization doesn't release the default
+        arguments tuple it didn't take a reference to.
+        """
+        defargs = tuple(range(3))
+        refct = sys.getrefcount(defargs)
+        for _ in range(3):
+            disp = _dispatcher.Dispatcher.__new__(_dispatcher.Dispatcher)
+            with self.assertRaises(TypeError) as raises:
+                disp.__init__(0, 1, False, (1,), defargs, False)
+            self.assertIn("argument names must be str",
+                          str(raises.exception))
+            del disp
+        self.assertEqual(sys.getrefcount(defargs), refct)
+
     def test_default_args(self):
         """
         Test omitting arguments with a default value.
@@ -1000,6 +1248,68 @@ class TestDispatcherMethods(TestCase):
         self.assertEqual(exp_f, got_f)
 
 
+class TestSignatureManifest(TestCase):
+
+    def setUp(self):
+        self.path = os.path.join(temp_directory(self.__class__.__name__),
+                                 'manifest-%s' % self.id())
+        self.addCleanup(manifest.record_signatures, None)
+        self.reset_dispatcher()
+
+    def reset_dispatcher(self):
+        manifest_usecase._make_finalizer()()
+        manifest_usecase._reset_overloads()
+
+    def test_record(self):
+        @jit(nopython=True)
+        def closure(x):
+            return x
+
+        manifest.record_signatures(self.path)
+        manifest_usecase(1, 2)
+        manifest_usecase(1.0, 2.0)
+        manifest_usecase(3, 4)
+        closure(1)
+        manifest.record_signatures(None)
+        manifest_usecase(1j, 2j)
+
+        expected = [(__name__, 'manifest_usecase', (types.intp, types.intp)),
+                    (__name__, 'manifest_usecase',
+                     (types.float64, types.float64))]
+        self.assertEqual(manifest._read_records(self.path), expected)
+
+        # Recording again doesn't duplicate the entries
+        manifest.record_signatures(self.path)
+        self.reset_dispatcher()
+        manifest_usecase(1, 2)
+        manifest_usecase(1j, 2j)
+        self.assertEqual(manifest._read_records(self.path),
+                         expected + [(__name__, 'manifest_usecase',
+                                      (types.complex128, types.complex128))])
+
+    def test_load(self):
+        manifest.record_signatures(self.path)
+        manifest_usecase(1, 2)
+        manifest_usecase(1.0, 2.0)
+        manifest.record_signatures(None)
+        with open(self.path, 'ab') as f:
+            pickle.dump((__name__, 'no_such_function', (types.intp,)), f)
+
+        self.reset_dispatcher()
+        self.assertEqual(manifest_usecase.signatures, [])
+        with warnings.catch_warnings(record=True) as w:
+            warnings.simplefilter('always', NumbaWarning)
+            self.assertEqual(manifest.load_manifest(self.path, threads=2), 2)
+        self.assertEqual(len(w), 1)
+        self.assertIn("no_such_function", str(w[0].message))
+        self.assertEqual(set(manifest_usecase.signatures),
+                         {(types.intp, types.intp),
+                          (types.float64, types.float64)})
+
+        # A missing manifest is empty
+        self.assertEqual(manifest.load_manifest(self.path + '.missing'), 0)
+
+
 class BaseCacheTest(TestCase):
     # This class is also used in test_cfunc.py.
 
@@ -1147,6 +1457,63 @@ class TestCache(BaseCacheUsecasesTest):
         # Check the code runs ok from another process
         self.run_in_separate_process()
 
+    def test_lazy_loading(self):
+        from numba.core.dispatcher import _LazyCompileResult
+
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        self.assertPreciseEqual(f(2.5, 3), 6.5)
+
+        mod = self.import_module()
+        f = mod.add_usecase
+        sigs = [(types.intp, types.intp), (types.float64, types.intp)]
+        for sig in sigs:
+            f.compile(sig)
+        self.check_hits(f, 2, 0)
+        # Only looked up in the index until needed
+        for sig in sigs:
+            self.assertIsInstance(f.overloads[sig], _LazyCompileResult)
+        self.assertEqual(sorted(map(str, f.nopython_signatures)),
+                         ['(float64, int64) -> float64',
+                          '(int64, int64) -> int64'])
+        for sig in sigs:
+            self.assertIsInstance(f.overloads[sig], _LazyCompileResult)
+        f.enable_call_stats()
+        self.assertPreciseEqual(f(2, 3), 6)
+        self.assertNotIsInstance(f.overloads[sigs[0]], _LazyCompileResult)
+        self.assertIsInstance(f.overloads[sigs[1]], _LazyCompileResult)
+        self.assertPreciseEqual(f(2, 3), 6)
+        # Loaded when a caller is compiled
+        g = jit(nopython=True)(lambda x: f(x, 1))
+        self.assertPreciseEqual(g(2.5), 4.5)
+        self.assertNotIsInstance(f.overloads[sigs[1]], _LazyCompileResult)
+        self.check_hits(f, 2, 0)
+        # Loading an overload keeps the call statistics
+        self.assertEqual(f.call_stats()[sigs[0]].calls, 2)
+
+    def test_lazy_loading_objmode(self):
+        from numba.core.dispatcher import _LazyCompileResult
+
+        mod = self.import_module()
+        f = mod.add_objmode_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+
+        mod = self.import_module()
+        f = mod.add_objmode_usecase
+        sig = (types.intp, types.intp)
+        f.compile(sig)
+        self.check_hits(f, 1, 0)
+        cres = f.overloads[sig]
+        self.assertIsInstance(cres, _LazyCompileResult)
+        self.assertTrue(cres.objectmode)
+        self.assertEqual(f.nopython_signatures, [])
+        self.assertIsInstance(f.overloads[sig], _LazyCompileResult)
+        # Registered as the fallback, so that other arguments load it
+        f.disable_compile()
+        self.assertPreciseEqual(f(2.5, 3), 6.5)
+        self.assertNotIsInstance(f.overloads[sig], _LazyCompileResult)
+
     def test_caching_nrt_pruned(self):
         self.check_pycache(0)
         mod = self.import_module()
@@ -1318,6 +1685,7 @@ class TestCache(BaseCacheUsecasesTest):
 
         mod = self.import_module()
         f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
         mod.Z = 10
         self.assertPreciseEqual(f(2, 3), 6)
         f.recompile()
@@ -1326,7 +1694,246 @@ class TestCache(BaseCacheUsecasesTest):
         # Freshly recompiled version is re-used from other imports
         mod = self.import_module()
         f = mod.add_usecase
+        mod.Z = 10
+        self.assertPreciseEqual(f(2, 3), 15)
+        self.check_hits(f, 1, 0)
+
+    def test_cache_invalidate_globals(self):
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+
+        # Globals are part of the cache key
+        mod = self.import_module()
+        f = mod.add_usecase
+        mod.Z = 10
         self.assertPreciseEqual(f(2, 3), 15)
+        self.check_hits(f, 0, 1)
+
+    def test_cache_touch(self):
+        mod = self.import_module()
+        self.assertPreciseEqual(mod.outer(2, 3), 0)
+
+        # Changing the file's timestamp doesn't invalidate the cache
+        st = os.stat(self.modfile)
+        os.utime(self.modfile, (st.st_atime + 10, st.st_mtime + 10))
+        mod = self.import_module()
+        self.assertPreciseEqual(mod.outer(2, 3), 0)
+        self.check_hits(mod.outer, 1, 0)
+
+    def test_cache_invalidate_source_file(self):
+        mod = self.import_module()
+        self.assertPreciseEqual(mod.add_usecase(2, 3), 6)
+
+        # Any change to the source file invalidates its functions, as
+        # e.g. the @overload implementations they use may be defined there
+        with open(self.modfile, "a") as f:
+            f.write("\n# Changed\n")
+        mod = self.import_module()
+        self.assertPreciseEqual(mod.add_usecase(2, 3), 6)
+        self.check_hits(mod.add_usecase, 0, 1)
+
+    def test_cache_invalidate_callee(self):
+        callee_name = self.modname + '_callee'
+        caller_name = self.modname + '_caller'
+        callee_file = os.path.join(self.tempdir, callee_name + '.py')
+        with open(callee_file, 'w') as f:
+            f.write("from numba import njit\n"
+                    "@njit\n"
+                    "def inner(x, y):\n"
+                    "    return x + y\n")
+        with open(os.path.join(self.tempdir, caller_name + '.py'), 'w') as f:
+            f.write("from numba import njit\n"
+                    "from %s import inner\n"
+                    "@njit(cache=True)\n"
+                    "def outer(x, y):\n"
+                    "    return inner(-y, x)\n" % callee_name)
+
+        def import_caller():
+            for name in (caller_name, callee_name):
+                sys.modules.pop(name, None)
+            return import_dynamic(caller_name)
+
+        self.addCleanup(sys.modules.pop, caller_name, None)
+        self.addCleanup(sys.modules.pop, callee_name, None)
+        mod = import_caller()
+        self.assertPreciseEqual(mod.outer(2, 3), -1)
+
+        mod = import_caller()
+        self.assertPreciseEqual(mod.outer(2, 3), -1)
+        self.check_hits(mod.outer, 1, 0)
+
+        # Changing the callee in the other module recompiles the caller
+        # (the size changes too, so that its bytecode isn't reused)
+        with open(callee_file, 'w') as f:
+            f.write("from numba import njit\n"
+                    "@njit\n"
+                    "def inner(x, y):\n"
+                    "    return x - 2 * y\n")
+        mod = import_caller()
+        self.assertPreciseEqual(mod.outer(2, 3), -7)
+        self.check_hits(mod.outer, 0, 1)
+
+    def test_cache_key_globals(self):
+        # The hashes of the globals in the cache key are the same in all
+        # processes, e.g. for containers of jitted functions (whose pickles
+        # hold a per-process uuid) and sets of strings (whose order depends
+        # on the hashing seed)
+        modname = self.modname + '_globals'
+        with open(os.path.join(self.tempdir, modname + '.py'), 'w') as f:
+            f.write("import numpy as np\n"
+                    "from numba import njit\n"
+                    "@njit\n"
+                    "def inner(x):\n"
+                    "    return x + 1\n"
+                    "FUNCS = (inner, [inner], {'inner': inner})\n"
+                    "NAMES = {'a', 'b', 'c', 'd', 'e', 'f'}\n"
+                    "ARR = np.arange(10)\n"
+                    "def outer():\n"
+                    "    return FUNCS, NAMES, ARR\n")
+        self.addCleanup(sys.modules.pop, modname, None)
+        code = """if 1:
+            import sys
+            sys.path.insert(0, %(tempdir)r)
+            from numba.core.caching import _FunctionHasher
+            mod = __import__(%(modname)r)
+            print(_FunctionHasher().hash_function(mod.outer))
+            """ % dict(tempdir=self.tempdir, modname=modname)
+
+        def get_hashes(seed):
+            env = dict(os.environ, PYTHONHASHSEED=str(seed))
+            popen = subprocess.Popen([sys.executable, "-c", code],
+                                     stdout=subprocess.PIPE,
+                                     stderr=subprocess.PIPE, env=env)
+            out, err = popen.communicate()
+            self.assertEqual(popen.returncode, 0, msg=err.decode())
+            return out.decode()
+
+        self.assertEqual(get_hashes(1), get_hashes(2))
+
+        # The jitted functions in the containers are followed
+        mod = import_dynamic(modname)
+        hashes = _FunctionHasher().hash_function(mod.outer)
+
+        @jit(nopython=True)
+        def inner(x):
+            return x + 2
+
+        mod.FUNCS = (inner, [mod.inner], {'inner': mod.inner})
+        new_hashes = _FunctionHasher().hash_function(mod.outer)
+        self.assertEqual(new_hashes[0], hashes[0])
+        self.assertNotEqual(new_hashes[1], hashes[1])
+
+    def test_cache_prune(self):
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        self.assertPreciseEqual(f(2.5, 3), 6.5)
+        self.assertPreciseEqual(mod.add_objmode_usecase(2, 3), 6)
+        self.check_pycache(5)
+
+        # Make the float signature the least recently used
+        overloads = f._cache._cache_file._load_index()
+        [data_name] = [v for k, v in overloads.items()
+                       if k[0] == (types.float64, types.int64)]
+        os.utime(os.path.join(self.cache_dir, data_name), (0, 0))
+
+        cache_dir = CacheDirectory(self.cache_dir)
+        stats = cache_dir.stats()
+        self.assertEqual(stats['functions'], 2)
+        self.assertEqual(stats['overloads'], 3)
+        self.assertEqual(stats['oldest_access'], 0)
+        # Nothing to remove
+        self.assertEqual(cache_dir.prune(), (0, 0))
+        self.check_pycache(5)
+        size = cache_dir.size()
+        nfiles, nbytes = cache_dir.prune(size - 1)
+        self.assertEqual(nfiles, 1)
+        self.assertLess(cache_dir.size(), size)
+        self.check_pycache(4)
+
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        self.assertPreciseEqual(f(2.5, 3), 6.5)
+        self.check_hits(f, 1, 1)
+
+        # Dead data files are always removed
+        dead = os.path.join(self.cache_dir,
+                            f._cache._impl.filename_base + '.99.nbc')
+        with open(dead, 'wb') as fp:
+            fp.write(b'dead')
+        self.assertEqual(cache_dir.stats()['dead_files'], 1)
+        self.assertEqual(cache_dir.prune(), (1, 4))
+        self.assertFalse(os.path.exists(dead))
+
+    def test_cache_access_time(self):
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        cache_file = f._cache._cache_file
+        [data_name] = cache_file._load_index().values()
+        data_path = os.path.join(self.cache_dir, data_name)
+        os.utime(data_path, (0, 0))
+        index_st = os.stat(cache_file._index_path)
+
+        # Loading the entry records the access on its data file, without
+        # rewriting the index, which is only read once
+        with mock.patch.object(IndexDataCacheFile, '_parse_index',
+                               autospec=True,
+                               side_effect=IndexDataCacheFile._parse_index) \
+                as parse:
+            mod = self.import_module()
+            f = mod.add_usecase
+            self.assertPreciseEqual(f(2, 3), 6)
+        self.check_hits(f, 1, 0)
+        self.assertEqual(parse.call_count, 1)
+        st = os.stat(data_path)
+        self.assertGreater(st.st_atime, 0)
+        self.assertEqual(st.st_mtime, 0)
+        self.assertEqual(os.stat(cache_file._index_path).st_mtime_ns,
+                         index_st.st_mtime_ns)
+        self.assertGreater(CacheDirectory(self.cache_dir).stats()
+                           ['oldest_access'], 0)
+
+    def test_cache_max_size(self):
+        cache_dir = CacheDirectory(self.cache_dir)
+        with override_config('CACHE_MAX_SIZE', 1000), \
+                mock.patch.object(CacheDirectory, 'size',
+                                  side_effect=cache_dir.size) as measure:
+            mod = self.import_module()
+            f = mod.add_usecase
+            self.assertPreciseEqual(f(2, 3), 6)
+            self.assertEqual(measure.call_count, 1)
+            # The size of the cache is estimated from the stamp file until
+            # the next rescan
+            self.assertPreciseEqual(f(2.5, 3), 6.5)
+            self.assertPreciseEqual(mod.add_objmode_usecase(2, 3), 6)
+            self.assertEqual(measure.call_count, 1)
+            size, saves, _ = cache_dir.read_size_stamp()
+            self.assertEqual(saves, 2)
+            self.assertGreater(size, 0)
+            with mock.patch.object(type(f._cache), '_size_rescan_saves', 3):
+                self.assertPreciseEqual(f(2, 3.5), 6.5)
+            self.assertEqual(measure.call_count, 2)
+            self.assertEqual(cache_dir.read_size_stamp()[:2],
+                             (cache_dir.size(), 0))
+
+    def test_cache_compression(self):
+        with override_config('CACHE_COMPRESSION', 6):
+            mod = self.import_module()
+            f = mod.add_usecase
+            self.assertPreciseEqual(f(2, 3), 6)
+        data_files = [fn for fn in self.cache_contents()
+                      if fn.endswith('.nbc')]
+        self.assertEqual(len(data_files), 1)
+        with open(os.path.join(self.cache_dir, data_files[0]), 'rb') as fp:
+            self.assertEqual(fp.read(4), b'NBZ1')
+
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        self.check_hits(f, 1, 0)
 
     def test_same_names(self):
         # Function with the same names should still disambiguate
@@ -1487,6 +2094,115 @@ class TestSequentialParForsCache(BaseCacheUsecasesTest):
         self.check_pycache(2)  # 1 index, 1 data
 
 
+class TestPackedCache(BaseCacheUsecasesTest):
+
+    def setUp(self):
+        super(TestPackedCache, self).setUp()
+        cm = override_env_config('NUMBA_CACHE_FORMAT', 'packed')
+        cm.__enter__()
+        self.addCleanup(cm.__exit__, None, None, None)
+        self.store_name = 'numba-cache.py%d%d%s.nbp' % (
+            sys.version_info[0], sys.version_info[1],
+            getattr(sys, 'abiflags', ''))
+
+    def test_caching(self):
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        self.assertPreciseEqual(f(2.5, 3), 6.5)
+        self.check_hits(f, 0, 2)
+        g = mod.add_objmode_usecase
+        self.assertPreciseEqual(g(2, 3), 6)
+        # A single file for all functions
+        self.assertEqual(self.cache_contents(), [self.store_name])
+
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        self.assertPreciseEqual(f(2.5, 3), 6.5)
+        self.check_hits(f, 2, 0)
+        g = mod.add_objmode_usecase
+        self.assertPreciseEqual(g(2, 3), 6)
+        self.check_hits(g, 1, 0)
+
+    def test_truncated_record(self):
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        # As left by a writer which crashed
+        with open(os.path.join(self.cache_dir, self.store_name), 'ab') as fp:
+            fp.write(b'NBR2\x10\x00')
+        self.assertPreciseEqual(f(2.5, 3), 6.5)
+
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        self.assertPreciseEqual(f(2.5, 3), 6.5)
+        self.check_hits(f, 2, 0)
+
+    def test_compaction(self):
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        path = os.path.join(self.cache_dir, self.store_name)
+        size = os.path.getsize(path)
+        # Each recompilation deletes the entries and saves new ones
+        with mock.patch.object(_PackedStore, '_compact_min_size', 0):
+            for i in range(10):
+                f.recompile()
+        self.assertLess(os.path.getsize(path), 2 * size)
+        self.assertEqual(self.cache_contents(), [self.store_name])
+
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        self.check_hits(f, 1, 0)
+
+    def test_cache_prune(self):
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        self.assertPreciseEqual(f(2.5, 3), 6.5)
+        self.assertPreciseEqual(mod.add_objmode_usecase(2, 3), 6)
+
+        cache_dir = CacheDirectory(self.cache_dir)
+        stats = cache_dir.stats()
+        self.assertEqual(stats['functions'], 2)
+        self.assertEqual(stats['overloads'], 3)
+        # The oldest record is evicted, not the whole store
+        size = cache_dir.size()
+        nfiles, nbytes = cache_dir.prune(size - 1)
+        self.assertEqual(nfiles, 0)
+        self.assertGreater(nbytes, 0)
+        self.assertEqual(cache_dir.size(), size - nbytes)
+        self.assertEqual(self.cache_contents(), [self.store_name])
+        self.assertEqual(cache_dir.stats()['overloads'], 2)
+
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        self.assertPreciseEqual(f(2.5, 3), 6.5)
+        self.check_hits(f, 1, 1)
+        self.assertPreciseEqual(mod.add_objmode_usecase(2, 3), 6)
+        self.check_hits(mod.add_objmode_usecase, 1, 0)
+
+    def test_superseded(self):
+        store_path = os.path.join(self.cache_dir, self.store_name)
+        store = _PackedStore.get(store_path)
+        mod = self.import_module()
+        f = mod.add_usecase
+        self.assertPreciseEqual(f(2, 3), 6)
+        keys = store.keys(f._cache._cache_file._filename_base)
+        self.assertEqual(len(keys), 1)
+        # Saving an entry for a new source stamp deletes those of the
+        # old one
+        f._cache._cache_file._source_stamp = 'stamp'
+        self.assertPreciseEqual(f(2.5, 3), 6.5)
+        new_keys = store.keys(f._cache._cache_file._filename_base)
+        self.assertEqual(len(new_keys), 1)
+        self.assertNotEqual(new_keys, keys)
+
+
 class TestCacheWithCpuSetting(BaseCacheUsecasesTest):
     # Disable parallel testing due to envvars modification
     _numba_parallel_test_ = False
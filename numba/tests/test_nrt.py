@@ -1,12 +1,19 @@
+import ctypes
+import gc
 import math
 import os
 import platform
 import sys
 import re
+import threading
+import weakref
 
 import numpy as np
 
-from numba import njit
+from numba import njit, typeof
+from numba.np.extensions import to_dlpack
+from numba.typed import Dict, List
+from numba.experimental import jitclass
 from numba.core import typing, types
 from numba.core.compiler import compile_isolated, Flags
 from numba.core.runtime import (
@@ -220,6 +227,100 @@ class TestNrtMemInfo(unittest.TestCase):
         # consumed by another thread.
 
 
+class TestNrtBiasedRefct(MemoryLeakMixin, TestCase):
+    """
+    Test MemInfos shared between their owner thread and other threads.
+    """
+
+    def test_release_after_owner_exit(self):
+        # The arrays are only referenced from the list, never from Python,
+        # so their MemInfos are not shared and stay biased towards the
+        # producer thread
+        @njit(nogil=True)
+        def produce(n):
+            l = List()
+            for i in range(n):
+                l.append(np.arange(i + 1))
+            return l
+
+        @njit
+        def clear(l):
+            while len(l):
+                l.pop()
+
+        # Compile both first
+        clear(produce(0))
+        lists = []
+        t = threading.Thread(target=lambda: lists.append(produce(10)))
+        t.start()
+        t.join()
+        [l] = lists
+        before = rtsys.get_allocation_stats()
+        clear(l)
+        after = rtsys.get_allocation_stats()
+        # The owner has exited: the releases are merged by this thread,
+        # which runs the destructors
+        self.assertEqual(after.mi_free - before.mi_free, 10)
+        del l
+        del lists[:]
+
+    def test_release_while_owner_idle(self):
+        @njit
+        def produce(n):
+            l = List()
+            for i in range(n):
+                l.append(np.arange(i + 1))
+            return l
+
+        @njit(nogil=True)
+        def clear(l):
+            while len(l):
+                l.pop()
+
+        # Compile both first
+        clear(produce(0))
+        l = produce(10)
+        before = rtsys.get_allocation_stats()
+        # This thread stays idle (not using the NRT) until the stats are
+        # taken: the releases are merged by the other thread, which runs
+        # the destructors
+        t = threading.Thread(target=clear, args=(l,))
+        t.start()
+        t.join()
+        after = rtsys.get_allocation_stats()
+        self.assertEqual(after.mi_free - before.mi_free, 10)
+        del l
+
+    def test_release_in_other_thread(self):
+        @njit(nogil=True)
+        def produce(n):
+            l = List()
+            for i in range(n):
+                l.append(np.arange(i))
+            return l
+
+        @njit(nogil=True)
+        def consume(l):
+            s = 0
+            while len(l):
+                s += l.pop().sum()
+            return s
+
+        expected = sum(np.arange(i).sum() for i in range(100))
+        for _ in range(3):
+            lists = []
+            t = threading.Thread(target=lambda: lists.append(produce(100)))
+            t.start()
+            t.join()
+            self.assertEqual(consume(lists[0]), expected)
+            # Let the producer run again while the consumer drops the list
+            t = threading.Thread(target=lambda: lists.append(produce(100)))
+            t.start()
+            del lists[0]
+            t.join()
+            self.assertEqual(consume(lists[0]), expected)
+
+
 class TestTracemalloc(unittest.TestCase):
     """
     Test NRT-allocated memory can be tracked by tracemalloc.
@@ -378,6 +479,484 @@ class TestNRTIssue(MemoryLeakMixin, TestCase):
 
         self.assertEqual(expect, got)
 
+    def test_array_boxing(self):
+        @njit
+        def new(n):
+            return np.arange(n).reshape((2, n // 2))
+
+        @njit
+        def same(a):
+            return a
+
+        @njit
+        def view(a):
+            return a[1:]
+
+        got = new(10)
+        np.testing.assert_equal(got, np.arange(10).reshape((2, 5)))
+        self.assertIs(type(got), np.ndarray)
+        self.assertIsInstance(got.base, nrt.MemInfo)
+        self.assertEqual(got.base.refcount, 1)
+        self.assertTrue(got.flags.writeable)
+        # An unchanged argument is returned as-is
+        self.assertIs(same(got), got)
+        v = view(got)
+        self.assertIsNot(v, got)
+        np.testing.assert_equal(v, got[1:])
+        del got
+        np.testing.assert_equal(v, np.arange(5, 10).reshape((1, 5)))
+
+
+class TestNrtArena(MemoryLeakMixin, TestCase):
+    """
+    Test functions compiled with ``arena=True``.
+    """
+
+    def test_temporaries(self):
+        def pyfunc(n):
+            acc = np.zeros(n)
+            for i in range(100):
+                tmp = np.arange(n) * i
+                acc += tmp + np.ones(n)
+            return acc
+
+        cfunc = njit(arena=True)(pyfunc)
+        for n in (1, 10, 1000):
+            np.testing.assert_equal(cfunc(n), pyfunc(n))
+        rtsys.release_arena()
+
+    def test_escaping_arrays(self):
+        @njit(arena=True)
+        def make(n):
+            return np.arange(n), np.empty(n)
+
+        @njit(arena=True)
+        def churn(n):
+            s = 0
+            for i in range(1000):
+                s += np.ones(n).sum()
+            return s
+
+        kept = [make(10)[0] for _ in range(100)]
+        # Recycling the arena must not clobber arrays still alive
+        self.assertEqual(churn(10), 10000)
+        rtsys.release_arena()
+        for arr in kept:
+            np.testing.assert_equal(arr, np.arange(10))
+
+    def test_large_allocation(self):
+        @njit(arena=True)
+        def big(n):
+            return np.ones(n)
+
+        n = 1 << 20
+        np.testing.assert_equal(big(n), np.ones(n))
+        rtsys.release_arena()
+
+    def test_memory_usage(self):
+        @njit(arena=True)
+        def make(n):
+            return np.ones(n)
+
+        rtsys.release_arena()
+        before = rtsys.get_memory_usage()
+        arr = make(10)
+        # The escaping array pins its whole chunk
+        self.assertGreaterEqual(rtsys.get_memory_usage() - before, 1 << 20)
+        rtsys.release_arena()
+        self.assertGreaterEqual(rtsys.get_memory_usage() - before, 1 << 20)
+        del arr
+        self.assertEqual(rtsys.get_memory_usage(), before)
+
+    def test_thread_exit(self):
+        @njit(arena=True)
+        def churn(n):
+            s = 0
+            for i in range(100):
+                s += np.ones(n).sum()
+            return s
+
+        before = rtsys.get_memory_usage()
+        results = []
+        th = threading.Thread(target=lambda: results.append(churn(10)))
+        th.start()
+        th.join()
+        self.assertEqual(results, [1000])
+        # The exiting thread gave back its chunk
+        self.assertEqual(rtsys.get_memory_usage(), before)
+
+
+class TestNrtMemoryLimit(MemoryLeakMixin, TestCase):
+    """
+    Test the NRT memory limit and soft limit callback.
+    """
+
+    def tearDown(self):
+        rtsys.set_memory_limit(0)
+        rtsys.set_memory_soft_limit(0, None)
+        super(TestNrtMemoryLimit, self).tearDown()
+
+    def test_memory_usage(self):
+        before = rtsys.get_memory_usage()
+        mi = rtsys.meminfo_alloc(1000)
+        self.assertEqual(rtsys.get_memory_usage(), before + 1000)
+        del mi
+        self.assertEqual(rtsys.get_memory_usage(), before)
+
+    def test_memory_limit(self):
+        @njit
+        def alloc(n):
+            return np.empty(n, dtype=np.uint8)
+
+        alloc(1)
+        rtsys.set_memory_limit(rtsys.get_memory_usage() + 10 ** 6)
+        alloc(1000)
+        with self.assertRaises(MemoryError) as raises:
+            alloc(10 ** 7)
+        self.assertIn("cannot allocate array", str(raises.exception))
+        with self.assertRaises(MemoryError):
+            rtsys.meminfo_alloc(10 ** 7)
+        rtsys.set_memory_limit(0)
+        self.assertEqual(alloc(10 ** 7).size, 10 ** 7)
+
+    def test_soft_limit(self):
+        @njit
+        def alloc(n):
+            return np.empty(n, dtype=np.uint8)
+
+        calls = []
+        alloc(1)
+        threshold = rtsys.get_memory_usage() + 10 ** 5
+        rtsys.set_memory_soft_limit(threshold, calls.append)
+        small = alloc(1000)
+        self.assertEqual(calls, [])
+        big = alloc(10 ** 5)
+        self.assertEqual(len(calls), 1)
+        self.assertGreater(calls[0], threshold)
+        # Already above the threshold, no new notification
+        alloc(10)
+        self.assertEqual(len(calls), 1)
+        del small, big
+        rtsys.set_memory_soft_limit(0, None)
+        alloc(10 ** 6)
+        self.assertEqual(len(calls), 1)
+
+    def test_memory_limit_containers(self):
+        @jitclass([('x', types.intp)])
+        class Point(object):
+            def __init__(self, x):
+                self.x = x
+
+        @njit
+        def new_list():
+            l = List()
+            l.append(1)
+            return l
+
+        @njit
+        def new_dict():
+            d = Dict()
+            d[1] = 1
+            return d
+
+        @njit
+        def new_point():
+            return Point(1)
+
+        cases = [(new_list, "cannot allocate typed list"),
+                 (new_dict, "cannot allocate typed dict"),
+                 (new_point, "cannot allocate jitclass instance")]
+        for fn, msg in cases:
+            # Compile and warm up before limiting
+            fn()
+            rtsys.set_memory_limit(rtsys.get_memory_usage() + 1)
+            with self.assertRaises(MemoryError) as raises:
+                fn()
+            self.assertIn(msg, str(raises.exception))
+            rtsys.set_memory_limit(0)
+            fn()
+
+
+class DLPackTensor(object):
+    """
+    A non-NumPy object exporting an array through DLPack.
+    """
+
+    def __init__(self, arr):
+        self.arr = arr
+
+    def __dlpack__(self, stream=None):
+        return self.arr.__dlpack__()
+
+    def __dlpack_device__(self):
+        return self.arr.__dlpack_device__()
+
+
+class DLPackCapsuleHolder(object):
+
+    def __init__(self, capsule):
+        self.capsule = capsule
+
+    def __dlpack__(self, stream=None):
+        return self.capsule
+
+    def __dlpack_device__(self):
+        return (1, 0)
+
+
+class DLDevice(ctypes.Structure):
+    _fields_ = [('device_type', ctypes.c_int32),
+                ('device_id', ctypes.c_int32)]
+
+
+class DLDataType(ctypes.Structure):
+    _fields_ = [('code', ctypes.c_uint8),
+                ('bits', ctypes.c_uint8),
+                ('lanes', ctypes.c_uint16)]
+
+
+class DLTensor(ctypes.Structure):
+    _fields_ = [('data', ctypes.c_void_p),
+                ('device', DLDevice),
+                ('ndim', ctypes.c_int32),
+                ('dtype', DLDataType),
+                ('shape', ctypes.POINTER(ctypes.c_int64)),
+                ('strides', ctypes.POINTER(ctypes.c_int64)),
+                ('byte_offset', ctypes.c_uint64)]
+
+
+class DLManagedTensor(ctypes.Structure):
+    pass
+
+
+DLDeleter = ctypes.CFUNCTYPE(None, ctypes.POINTER(DLManagedTensor))
+
+DLManagedTensor._fields_ = [('dl_tensor', DLTensor),
+                            ('manager_ctx', ctypes.c_void_p),
+                            ('deleter', DLDeleter)]
+
+
+class CtypesDLPackTensor(object):
+    """
+    An object exporting a NumPy array through hand-built DLPack capsules,
+    so that the C paths are exercised whatever the NumPy version.  Counts
+    the exports and the deleter calls.
+    """
+
+    def __init__(self, arr):
+        self.arr = arr
+        self.exports = 0
+        self.deleted = 0
+        self._live = {}
+        self._deleter = DLDeleter(self._delete)
+
+    def _delete(self, managed):
+        self.deleted += 1
+        del self._live[ctypes.addressof(managed.contents)]
+
+    def __dlpack__(self, stream=None):
+        arr = self.arr
+        itemsize = arr.dtype.itemsize
+        shape = (ctypes.c_int64 * arr.ndim)(*arr.shape)
+        strides = (ctypes.c_int64 * arr.ndim)(*[s // itemsize
+                                                for s in arr.strides])
+        managed = DLManagedTensor()
+        t = managed.dl_tensor
+        t.data = arr.ctypes.data
+        t.device.device_type = 1   # kDLCPU
+        t.ndim = arr.ndim
+        t.dtype.code = {'i': 0, 'u': 1, 'f': 2}[arr.dtype.kind]
+        t.dtype.bits = itemsize * 8
+        t.dtype.lanes = 1
+        t.shape = shape
+        t.strides = strides
+        managed.deleter = self._deleter
+        self._live[ctypes.addressof(managed)] = (managed, shape, strides)
+        self.exports += 1
+        capsule_new = ctypes.pythonapi.PyCapsule_New
+        capsule_new.restype = ctypes.py_object
+        capsule_new.argtypes = [ctypes.c_void_p, ctypes.c_char_p,
+                                ctypes.c_void_p]
+        return capsule_new(ctypes.addressof(managed), b"dltensor", None)
+
+    def __dlpack_device__(self):
+        return (1, 0)
+
+
+class TestNrtDLPackCtypes(MemoryLeakMixin, TestCase):
+    """
+    Test DLPack import and export with hand-built tensors.
+    """
+
+    def test_typeof(self):
+        arr = np.arange(12, dtype=np.int32).reshape((3, 4))
+        self.assertEqual(typeof(CtypesDLPackTensor(arr)),
+                         types.Array(types.int32, 2, 'C'))
+        self.assertEqual(typeof(CtypesDLPackTensor(arr.T)),
+                         types.Array(types.int32, 2, 'F'))
+        self.assertEqual(typeof(CtypesDLPackTensor(arr[:, ::2])),
+                         types.Array(types.int32, 2, 'A'))
+
+    def test_import(self):
+        @njit
+        def double(a):
+            a *= 2
+            return a.sum()
+
+        arr = np.arange(12.0).reshape((3, 4))[:, ::2]
+        expected = arr * 2
+        tensor = CtypesDLPackTensor(arr)
+        self.assertEqual(double(tensor), expected.sum())
+        # Zero-copy: the original array is updated
+        np.testing.assert_equal(arr, expected)
+        # The same export is used for typing and unboxing, and the
+        # deleter runs once the array is released
+        self.assertEqual(tensor.exports, 1)
+        self.assertEqual(tensor.deleted, 1)
+        self.assertEqual(double(tensor), expected.sum() * 2)
+        self.assertEqual(tensor.exports, 2)
+        self.assertEqual(tensor.deleted, 2)
+
+    def test_import_lifetime(self):
+        @njit
+        def ident(a):
+            return a
+
+        tensor = CtypesDLPackTensor(np.arange(10, dtype=np.uint16))
+        got = ident(tensor)
+        np.testing.assert_equal(got, np.arange(10))
+        self.assertEqual(tensor.deleted, 0)
+        del got
+        self.assertEqual(tensor.deleted, 1)
+
+    def test_typing_only(self):
+        @njit
+        def first(a):
+            return a[0]
+
+        first(np.arange(3))
+        first.disable_compile()
+        tensor = CtypesDLPackTensor(np.arange(3.0))
+        ref = weakref.ref(tensor)
+        # Neither typing alone nor a call that doesn't unbox the tensor
+        # keeps its export, which would keep the tensor alive
+        self.assertEqual(typeof(tensor), types.Array(types.float64, 1, 'C'))
+        with self.assertRaises(TypeError):
+            first(tensor)
+        del tensor
+        # The tensor is in a reference cycle through its deleter
+        gc.collect()
+        self.assertIsNone(ref())
+
+    def test_import_mismatch(self):
+        adapt = ctypes.PYFUNCTYPE(
+            ctypes.c_int, ctypes.py_object, ctypes.c_int, ctypes.c_int,
+            ctypes.c_void_p)(_nrt_python.c_helpers['adapt_array_from_python'])
+        release = ctypes.PYFUNCTYPE(None, ctypes.c_void_p)(
+            _nrt_python.c_helpers['MemInfo_release'])
+        tensor = CtypesDLPackTensor(np.zeros((1,) * 8))
+        # Room for the fixed fields and 8 dimensions
+        arystruct = (ctypes.c_ssize_t * (5 + 2 * 8))()
+        # The tensor unboxed may not be the one the type was computed
+        # from: it is rejected instead of overrunning the array structure
+        self.assertEqual(adapt(tensor, 2, 8, arystruct), -1)
+        self.assertEqual(adapt(tensor, 8, 4, arystruct), -1)
+        self.assertEqual(tensor.deleted, 0)
+        self.assertEqual(adapt(tensor, 8, 8, arystruct), 0)
+        self.assertEqual(arystruct[2:4], [1, 8])
+        release(arystruct[0])
+        self.assertEqual(tensor.deleted, 1)
+
+    def test_export(self):
+        @njit
+        def make(n):
+            return to_dlpack(np.arange(n).reshape((2, n // 2)).T)
+
+        capsule = make(10)
+        get_pointer = ctypes.pythonapi.PyCapsule_GetPointer
+        get_pointer.restype = ctypes.c_void_p
+        get_pointer.argtypes = [ctypes.py_object, ctypes.c_char_p]
+        managed = DLManagedTensor.from_address(
+            get_pointer(capsule, b"dltensor"))
+        t = managed.dl_tensor
+        self.assertEqual(t.device.device_type, 1)
+        self.assertEqual((t.dtype.code, t.dtype.bits, t.dtype.lanes),
+                         (0, 64, 1))
+        self.assertEqual(t.ndim, 2)
+        self.assertEqual(t.shape[:2], [5, 2])
+        self.assertEqual(t.strides[:2], [1, 5])
+        data = (ctypes.c_int64 * 10).from_address(t.data)
+        self.assertEqual(list(data), list(range(10)))
+        # Consume the capsule and release the tensor, as a consumer would
+        set_name = ctypes.pythonapi.PyCapsule_SetName
+        set_name.argtypes = [ctypes.py_object, ctypes.c_char_p]
+        set_name(capsule, b"used_dltensor")
+        managed.deleter(ctypes.pointer(managed))
+
+
+@unittest.skipUnless(hasattr(np.ndarray, '__dlpack__'),
+                     "needs NumPy with DLPack support")
+class TestNrtDLPack(MemoryLeakMixin, TestCase):
+    """
+    Test DLPack import and export.
+    """
+
+    def test_typeof(self):
+        arr = np.arange(12, dtype=np.float32).reshape((3, 4))
+        self.assertEqual(typeof(DLPackTensor(arr)),
+                         types.Array(types.float32, 2, 'C'))
+        self.assertEqual(typeof(DLPackTensor(arr.T)),
+                         types.Array(types.float32, 2, 'F'))
+        self.assertEqual(typeof(DLPackTensor(arr[:, ::2])),
+                         types.Array(types.float32, 2, 'A'))
+
+    def test_import(self):
+        @njit
+        def double(a):
+            a *= 2
+            return a.sum()
+
+        for arr in (np.arange(10), np.arange(12.0).reshape((3, 4)).T,
+                    np.arange(20, dtype=np.uint8)[::3]):
+            expected = arr * 2
+            tensor = DLPackTensor(arr)
+            self.assertEqual(double(tensor), expected.sum())
+            # Zero-copy: the original array is updated
+            np.testing.assert_equal(arr, expected)
+
+    def test_import_lifetime(self):
+        @njit
+        def ident(a):
+            return a
+
+        arr = np.arange(100.0)
+        got = ident(DLPackTensor(arr))
+        self.assertIsNot(got, arr)
+        del arr
+        np.testing.assert_equal(got, np.arange(100.0))
+
+    def test_export(self):
+        @njit
+        def make(n):
+            return to_dlpack(np.arange(n).reshape((2, n // 2)).T)
+
+        capsule = make(10)
+        got = np.from_dlpack(DLPackCapsuleHolder(capsule))
+        np.testing.assert_equal(got, np.arange(10).reshape((2, 5)).T)
+        del capsule
+        np.testing.assert_equal(got, np.arange(10).reshape((2, 5)).T)
+        del got
+        # An unconsumed capsule releases the array
+        make(10)
+
+    def test_roundtrip(self):
+        @njit
+        def total(a):
+            return a.sum()
+
+        capsule = to_dlpack(np.arange(5, dtype=np.int16))
+        self.assertEqual(total(DLPackCapsuleHolder(capsule)), 10)
+
 
 class TestRefCtPruning(unittest.TestCase):
 
@@ -1591,3 +1591,118 @@ class TestListFromIter(MemoryLeakMixin, TestCase):
             "List() takes no keyword arguments",
             str(raises.exception),
         )
+
+
+class TestListFromArray(MemoryLeakMixin, TestCase):
+    """Test bulk construction of typed-lists from arrays."""
+
+    def test_constructor(self):
+        for arr in (np.arange(1000), np.linspace(0, 1, 10, dtype=np.float32),
+                    np.array([True, False, True]), np.arange(20)[::3]):
+            tl = List(arr)
+            self.assertEqual(tl._dtype, typeof(arr).dtype)
+            self.assertEqual(list(tl), list(arr))
+
+    def test_constructor_jit(self):
+        @njit
+        def foo(arr):
+            return List(arr)
+
+        for arr in (np.arange(100.0), np.arange(20)[::3],
+                    np.arange(12).reshape((3, 4)).T[0]):
+            self.assertEqual(list(foo(arr)), list(arr))
+
+    def test_extend(self):
+        @njit
+        def foo(l, arr):
+            l.extend(arr)
+            return l
+
+        tl = List([1, 2])
+        foo(tl, np.arange(10))
+        self.assertEqual(list(tl), [1, 2] + list(range(10)))
+        # Items of another type are converted one by one
+        foo(tl, np.array([7], dtype=np.int32))
+        self.assertEqual(tl[-1], 7)
+        with self.assertRaises(BufferError):
+            foo(tl, tl.asarray())
+
+
+class TestListAsArray(MemoryLeakMixin, TestCase):
+    """Test zero-copy array views of the typed-list items."""
+
+    def test_asarray(self):
+        for dtype, items in ((np.int64, [1, 2, 3]),
+                             (np.float32, [1.5, 2.5]),
+                             (np.bool_, [True, False, True]),
+                             (np.complex128, [1j, 2 + 3j])):
+            tl = List([dtype(x) for x in items])
+            arr = tl.asarray()
+            self.assertEqual(arr.dtype, dtype)
+            np.testing.assert_equal(arr, np.array(items, dtype=dtype))
+            np.testing.assert_equal(np.asarray(tl), arr)
+
+    def test_view(self):
+        tl = List(np.arange(5.0))
+        arr = tl.asarray()
+        # Writes go through both ways
+        arr[0] = 42
+        self.assertEqual(tl[0], 42)
+        tl[1] = 43
+        self.assertEqual(arr[1], 43)
+        # The array keeps the list alive
+        del tl
+        np.testing.assert_equal(arr, [42, 43, 2, 3, 4])
+
+    def test_asarray_jit(self):
+        @njit
+        def foo(n):
+            l = List()
+            for i in range(n):
+                l.append(i * 2)
+            arr = l.asarray()
+            return arr.sum(), arr
+
+        total, arr = foo(10)
+        self.assertEqual(total, 90)
+        np.testing.assert_equal(arr, np.arange(10) * 2)
+
+    def test_resize_while_exported(self):
+        tl = List([1, 2, 3])
+        arr = tl.asarray()
+        with self.assertRaises(BufferError):
+            tl.append(4)
+        with self.assertRaises(BufferError):
+            tl.pop()
+        with self.assertRaises(BufferError):
+            del tl[:2]
+        np.testing.assert_equal(arr, [1, 2, 3])
+        # Views hold the export too
+        view = arr[1:]
+        del arr
+        with self.assertRaises(BufferError):
+            tl.append(4)
+        del view
+        tl.append(4)
+        self.assertEqual(list(tl), [1, 2, 3, 4])
+
+    def test_empty(self):
+        tl = List.empty_list(types.float64)
+        self.assertEqual(tl.asarray().shape, (0,))
+        self.assertEqual(np.asarray(List()).shape, (0,))
+
+    def test_unsupported(self):
+        tl = List(['a', 'b'])
+        with self.assertRaises(TypeError):
+            tl.asarray()
+        # Falls back to a copy
+        np.testing.assert_equal(np.asarray(tl), np.array(['a', 'b']))
+
+        @njit
+        def foo(l):
+            return l.asarray()
+
+        with self.assertRaises(TypingError) as raises:
+            foo(tl)
+        self.assertIn("asarray() needs a list of numbers or booleans",
+                      str(raises.exception))
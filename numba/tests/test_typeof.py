@@ -527,6 +527,48 @@ class TestFingerprint(TestCase):
         with self.assertRaises(NotImplementedError):
             compute_fingerprint(frozenset([2, 3]))
 
+    def test_str(self):
+        s = compute_fingerprint('a')
+        self.assertEqual(compute_fingerprint('\u20ac' * 5), s)
+        self.assertNotEqual(compute_fingerprint(b'a'), s)
+        self.assertEqual(compute_fingerprint(('a', 1)),
+                         compute_fingerprint(('bc', 2)))
+
+        class MyStr(str):
+            pass
+
+        with self.assertRaises(NotImplementedError):
+            compute_fingerprint(MyStr('a'))
+
+    def test_cached_types(self):
+        # Typed containers and jitclass instances are fingerprinted from
+        # the type they carry
+        from numba.typed import List, Dict
+        from numba.experimental import jitclass
+
+        distinct = DistinctChecker()
+
+        s = compute_fingerprint(List([1, 2]))
+        self.assertEqual(compute_fingerprint(List([3])), s)
+        distinct.add(s)
+        distinct.add(compute_fingerprint(List([1.5])))
+        d = Dict.empty(types.int64, types.float64)
+        distinct.add(compute_fingerprint(d))
+        distinct.add(compute_fingerprint((d, List([1.5]))))
+
+        @jitclass([('x', types.int64)])
+        class Point(object):
+            def __init__(self, x):
+                self.x = x
+
+        s = compute_fingerprint(Point(1))
+        self.assertEqual(compute_fingerprint(Point(2)), s)
+        distinct.add(s)
+
+        # An untyped container can't be fingerprinted
+        with self.assertRaises(NotImplementedError):
+            compute_fingerprint(List())
+
     def test_omitted_args(self):
         distinct = DistinctChecker()
 
@@ -70,13 +70,15 @@ class Status(IntEnum):
     ERR_CMP_FAILED = -5
 
 
-def new_dict(key, value):
+def new_dict(key, value, n_keys=0):
     """Construct a new dict.
 
     Parameters
     ----------
     key, value : TypeRef
         Key type and value type of the new dict.
+    n_keys : int
+        The number of keys to allocate space for.
     """
     # With JIT disabled, ignore all arguments and return a Python dict.
     return dict()
@@ -206,27 +208,31 @@ def _imp_dtor(context, module):
 
 
 @intrinsic
-def _dict_new_minsize(typingctx, keyty, valty):
-    """Wrap numba_dict_new_minsize.
+def _dict_new_sized(typingctx, n_keys, keyty, valty):
+    """Wrap numba_dict_new_sized.
 
-    Allocate a new dictionary object with the minimum capacity.
+    Allocate a new dictionary object with enough space to hold
+    *n_keys* keys without resizing.
 
     Parameters
     ----------
+    n_keys: int
+        The number of keys to insert into the dictionary.
     keyty, valty: Type
         Type of the key and value, respectively.
 
     """
     resty = types.voidptr
-    sig = resty(keyty, valty)
+    sig = resty(types.intp, keyty, valty)
 
     def codegen(context, builder, sig, args):
+        n_keys = args[0]
         fnty = ir.FunctionType(
             ll_status,
-            [ll_dict_type.as_pointer(), ll_ssize_t, ll_ssize_t],
+            [ll_dict_type.as_pointer(), ll_ssize_t, ll_ssize_t, ll_ssize_t],
         )
         fn = builder.module.get_or_insert_function(
-            fnty, name='numba_dict_new_minsize')
+            fnty, name='numba_dict_new_sized')
         # Determine sizeof key and value types
         ll_key = context.get_data_type(keyty.instance_type)
         ll_val = context.get_data_type(valty.instance_type)
@@ -235,7 +241,7 @@ def _dict_new_minsize(typingctx, keyty, valty):
         refdp = cgutils.alloca_once(builder, ll_dict_type, zfill=True)
         status = builder.call(
             fn,
-            [refdp, ll_ssize_t(sz_key), ll_ssize_t(sz_val)],
+            [refdp, n_keys, ll_ssize_t(sz_key), ll_ssize_t(sz_val)],
         )
         _raise_if_error(
             context, builder, status,
@@ -620,6 +626,12 @@ def _make_dict(typingctx, keyty, valty, ptr):
             context.get_constant(types.uintp, alloc_size),
             dtor,
         )
+        with builder.if_then(cgutils.is_null(builder, meminfo),
+                             likely=False):
+            # Don't leak the underlying dictionary
+            _call_dict_free(context, builder, ptr)
+        cgutils.guard_memory_error(context, builder, meminfo,
+                                   "cannot allocate typed dict")
 
         data_pointer = context.nrt.meminfo_data(builder, meminfo)
         data_pointer = builder.bitcast(data_pointer, ll_dict_type.as_pointer())
@@ -634,7 +646,7 @@ def _make_dict(typingctx, keyty, valty, ptr):
 
 
 @overload(new_dict)
-def impl_new_dict(key, value):
+def impl_new_dict(key, value, n_keys=0):
     """Creates a new dictionary with *key* and *value* as the type
     of the dictionary key and value, respectively.
     """
@@ -646,8 +658,10 @@ def impl_new_dict(key, value):
 
     keyty, valty = key, value
 
-    def imp(key, value):
-        dp = _dict_new_minsize(keyty, valty)
+    def imp(key, value, n_keys=0):
+        if n_keys < 0:
+            raise RuntimeError("expecting *n_keys* to be >= 0")
+        dp = _dict_new_sized(n_keys, keyty, valty)
         _dict_set_method_table(dp, keyty, valty)
         d = _make_dict(keyty, valty, dp)
         return d
@@ -832,7 +846,7 @@ def impl_copy(d):
     key_type, val_type = d.key_type, d.value_type
 
     def impl(d):
-        newd = new_dict(key_type, val_type)
+        newd = new_dict(key_type, val_type, n_keys=len(d))
         for k, v in d.items():
             newd[k] = v
         return newd
@@ -36,6 +36,7 @@ from numba.typed.typedobjectutils import (_as_bytes, _cast, _nonoptional,
                                           _container_get_data,
                                           _container_get_meminfo,)
 from numba.cpython import listobj
+from numba.np import arrayobj
 
 ll_list_type = cgutils.voidptr_t
 ll_listiter_type = cgutils.voidptr_t
@@ -84,6 +85,7 @@ class ListStatus(IntEnum):
     LIST_ERR_MUTATED = -3
     LIST_ERR_ITER_EXHAUSTED = -4
     LIST_ERR_IMMUTABLE = -5
+    LIST_ERR_EXPORTED = -6
 
 
 class ErrorHandler(object):
@@ -286,6 +288,11 @@ def _add_meminfo(context, builder, lstruct):
         context.get_constant(types.uintp, alloc_size),
         dtor,
     )
+    with builder.if_then(cgutils.is_null(builder, meminfo), likely=False):
+        # Don't leak the underlying list
+        _call_list_free(context, builder, lstruct.data)
+    cgutils.guard_memory_error(context, builder, meminfo,
+                               "cannot allocate typed list")
 
     data_pointer = context.nrt.meminfo_data(builder, meminfo)
     data_pointer = builder.bitcast(data_pointer, ll_list_type.as_pointer())
@@ -586,6 +593,39 @@ def _list_append(typingctx, l, item):
     return sig, codegen
 
 
+@intrinsic
+def _list_append_items(typingctx, l, arr):
+    """Wrap numba_list_append_items, appending the items of the contiguous
+    array *arr*, whose dtype must be the item type.
+    """
+    resty = types.int32
+    sig = resty(l, arr)
+
+    def codegen(context, builder, sig, args):
+        fnty = ir.FunctionType(
+            ll_status,
+            [ll_list_type, ll_bytes, ll_ssize_t],
+        )
+        [l, arr] = args
+        [tl, tarr] = sig.args
+        fn = builder.module.get_or_insert_function(
+            fnty, name='numba_list_append_items')
+
+        ary = arrayobj.make_array(tarr)(context, builder, value=arr)
+        lp = _container_get_data(context, builder, tl, l)
+        status = builder.call(
+            fn,
+            [
+                lp,
+                _as_bytes(builder, ary.data),
+                ary.nitems,
+            ],
+        )
+        return status
+
+    return sig, codegen
+
+
 @overload_method(types.ListType, 'append')
 def impl_append(l, item):
     if not isinstance(l, types.ListType):
@@ -600,6 +640,8 @@ def impl_append(l, item):
             return
         elif status == ListStatus.LIST_ERR_IMMUTABLE:
             raise ValueError('list is immutable')
+        elif status == ListStatus.LIST_ERR_EXPORTED:
+            raise BufferError('list cannot be resized while exported')
         elif status == ListStatus.LIST_ERR_NO_MEMORY:
             raise MemoryError('Unable to allocate memory to append item')
         else:
@@ -966,6 +1008,8 @@ def impl_delitem(l, index):
                 return
             elif status == ListStatus.LIST_ERR_IMMUTABLE:
                 raise ValueError("list is immutable")
+            elif status == ListStatus.LIST_ERR_EXPORTED:
+                raise BufferError("list cannot be resized while exported")
             else:
                 raise AssertionError("internal list error during delitem")
         return integer_impl
@@ -980,6 +1024,8 @@ def impl_delitem(l, index):
                 slice_range.step)
             if status == ListStatus.LIST_ERR_MUTATED:
                 raise ValueError("list is immutable")
+            elif status == ListStatus.LIST_ERR_EXPORTED:
+                raise BufferError("list cannot be resized while exported")
         return slice_impl
 
     else:
@@ -1034,7 +1080,27 @@ def impl_extend(l, iterable):
     _check_for_none_typed(l, 'extend')
 
     def select_impl():
-        if isinstance(iterable, types.ListType):
+        if (isinstance(iterable, types.Array) and iterable.ndim == 1
+                and iterable.layout in 'CF'
+                and iterable.dtype == l.item_type
+                and _is_buffer_compatible(l.item_type)):
+            # Copy the items at once
+            def impl(l, iterable):
+                status = _list_append_items(l, iterable)
+                if status == ListStatus.LIST_OK:
+                    return
+                elif status == ListStatus.LIST_ERR_IMMUTABLE:
+                    raise ValueError('list is immutable')
+                elif status == ListStatus.LIST_ERR_EXPORTED:
+                    raise BufferError('list cannot be resized while exported')
+                elif status == ListStatus.LIST_ERR_NO_MEMORY:
+                    raise MemoryError('Unable to allocate memory to extend '
+                                      'list')
+                else:
+                    raise RuntimeError('list.extend failed unexpectedly')
+
+            return impl
+        elif isinstance(iterable, types.ListType):
             def impl(l, iterable):
                 if not l._is_mutable():
                     raise ValueError("list is immutable")
@@ -1275,6 +1341,113 @@ def impl_dtype(l):
     return impl
 
 
+def _is_buffer_compatible(itemty):
+    """Whether the items of a list of *itemty* can be exported as an array.
+    """
+    return isinstance(itemty, (types.Number, types.Boolean,
+                               types.NPDatetime, types.NPTimedelta))
+
+
+def _imp_export_dtor(context, module):
+    """Define the dtor for the MemInfo of an export of the list items.
+
+    The payload holds the C list pointer and the MemInfo of the list.
+    """
+    llvoidptr = context.get_value_type(types.voidptr)
+    llsize = context.get_value_type(types.uintp)
+    fnty = ir.FunctionType(
+        ir.VoidType(),
+        [llvoidptr, llsize, llvoidptr],
+    )
+    fname = '_numba_list_export_dtor'
+    fn = module.get_or_insert_function(fnty, name=fname)
+
+    if fn.is_declaration:
+        # Set linkage
+        fn.linkage = 'linkonce_odr'
+        # Define
+        builder = ir.IRBuilder(fn.append_basic_block())
+        payload = builder.bitcast(fn.args[0], ll_voidptr_type.as_pointer())
+        lp = builder.load(cgutils.gep(builder, payload, 0))
+        mi = builder.load(cgutils.gep(builder, payload, 1))
+        release_fnty = ir.FunctionType(ir.VoidType(), [ll_list_type])
+        release = module.get_or_insert_function(
+            release_fnty, name='numba_list_release_buffer')
+        builder.call(release, [lp])
+        context.nrt.decref(builder, _meminfo_listptr, mi)
+        builder.ret_void()
+
+    return fn
+
+
+@intrinsic
+def _list_as_array(typingctx, l):
+    """Make a 1D array viewing the items of list *l*.
+
+    The array holds an export of the list, which cannot change size while
+    the array is alive.
+    """
+    arrayty = types.Array(l.item_type, 1, 'C')
+    sig = arrayty(l)
+
+    def codegen(context, builder, sig, args):
+        [tl] = sig.args
+        [l] = args
+        aryty = sig.return_type
+        lstruct = cgutils.create_struct_proxy(tl)(context, builder, value=l)
+        lp = lstruct.data
+
+        meminfo = context.nrt.meminfo_alloc_dtor(
+            builder,
+            context.get_constant(types.uintp,
+                                 2 * context.get_abi_sizeof(ll_voidptr_type)),
+            _imp_export_dtor(context, builder.module),
+        )
+        cgutils.guard_memory_error(context, builder, meminfo,
+                                   "cannot export list items")
+        payload = builder.bitcast(context.nrt.meminfo_data(builder, meminfo),
+                                  ll_voidptr_type.as_pointer())
+        builder.store(lp, cgutils.gep(builder, payload, 0))
+        builder.store(builder.bitcast(lstruct.meminfo, ll_voidptr_type),
+                      cgutils.gep(builder, payload, 1))
+        # The export holds a reference to the list
+        context.nrt.incref(builder, tl, l)
+
+        acquire = builder.module.get_or_insert_function(
+            ir.FunctionType(ll_bytes, [ll_list_type]),
+            name='numba_list_acquire_buffer')
+        length = builder.module.get_or_insert_function(
+            ir.FunctionType(ll_ssize_t, [ll_list_type]),
+            name='numba_list_length')
+        items = builder.call(acquire, [lp])
+
+        ary = arrayobj.make_array(aryty)(context, builder)
+        itemsize = context.get_abi_sizeof(context.get_data_type(aryty.dtype))
+        arrayobj.populate_array(ary,
+                                data=builder.bitcast(items, ary.data.type),
+                                shape=[builder.call(length, [lp])],
+                                strides=[itemsize],
+                                itemsize=itemsize,
+                                meminfo=meminfo)
+        return ary._getvalue()
+
+    return sig, codegen
+
+
+@overload_method(types.ListType, 'asarray')
+def impl_asarray(l):
+    if not isinstance(l, types.ListType):
+        return
+    if not _is_buffer_compatible(l.item_type):
+        raise TypingError("asarray() needs a list of numbers or booleans, "
+                          "not {}".format(l.item_type))
+
+    def impl(l):
+        return _list_as_array(l)
+
+    return impl
+
+
 def _equals_helper(this, other, OP):
     if not isinstance(this, types.ListType):
         return
@@ -20,8 +20,9 @@ from numba.core.typing import signature
 
 
 @njit
-def _make_dict(keyty, valty):
-    return dictobject._as_meminfo(dictobject.new_dict(keyty, valty))
+def _make_dict(keyty, valty, n_keys=0):
+    return dictobject._as_meminfo(dictobject.new_dict(keyty, valty,
+                                                      n_keys=n_keys))
 
 
 @njit
@@ -74,6 +75,11 @@ def _copy(d):
     return d.copy()
 
 
+@njit
+def _from_arrays(keys, values):
+    return Dict.from_arrays(keys, values)
+
+
 def _from_meminfo_ptr(ptr, dicttype):
     d = Dict(meminfo=ptr, dcttype=dicttype)
     return d
@@ -85,21 +91,39 @@ class Dict(MutableMapping):
     Implements the MutableMapping interface.
     """
 
-    def __new__(cls, dcttype=None, meminfo=None):
+    # The attribute holding the dict type, read by the C dispatcher
+    _numba_type_attr_ = '_dict_type'
+
+    def __new__(cls, dcttype=None, meminfo=None, n_keys=0):
         if config.DISABLE_JIT:
             return dict.__new__(dict)
         else:
             return object.__new__(cls)
 
     @classmethod
-    def empty(cls, key_type, value_type):
+    def empty(cls, key_type, value_type, n_keys=0):
         """Create a new empty Dict with *key_type* and *value_type*
         as the types for the keys and values of the dictionary respectively.
+
+        Optionally, allocate enough space to hold *n_keys* keys without
+        resizing.
         """
         if config.DISABLE_JIT:
             return dict()
         else:
-            return cls(dcttype=DictType(key_type, value_type))
+            return cls(dcttype=DictType(key_type, value_type), n_keys=n_keys)
+
+    @classmethod
+    def from_arrays(cls, keys, values):
+        """Create a new Dict mapping the items of the 1D array *keys* to the
+        corresponding items of the 1D array *values*.
+
+        The dictionary is built in a single compiled call.
+        """
+        if config.DISABLE_JIT:
+            return dict(zip(keys, values))
+        else:
+            return _from_arrays(keys, values)
 
     def __init__(self, **kwargs):
         """
@@ -112,20 +136,23 @@ class Dict(MutableMapping):
             Used internally for the dictionary type.
         meminfo : MemInfo; keyword-only
             Used internally to pass the MemInfo object when boxing.
+        n_keys : int; keyword-only
+            Used internally to pre-allocate space for keys
         """
         if kwargs:
             self._dict_type, self._opaque = self._parse_arg(**kwargs)
         else:
             self._dict_type = None
 
-    def _parse_arg(self, dcttype, meminfo=None):
+    def _parse_arg(self, dcttype, meminfo=None, n_keys=0):
         if not isinstance(dcttype, DictType):
             raise TypeError('*dcttype* must be a DictType')
 
         if meminfo is not None:
             opaque = meminfo
         else:
-            opaque = _make_dict(dcttype.key_type, dcttype.value_type)
+            opaque = _make_dict(dcttype.key_type, dcttype.value_type,
+                                n_keys)
         return dcttype, opaque
 
     @property
@@ -211,12 +238,34 @@ class Dict(MutableMapping):
 
 # XXX: should we have a better way to classmethod
 @overload_method(TypeRef, 'empty')
-def typeddict_empty(cls, key_type, value_type):
+def typeddict_empty(cls, key_type, value_type, n_keys=0):
     if cls.instance_type is not DictType:
         return
 
-    def impl(cls, key_type, value_type):
-        return dictobject.new_dict(key_type, value_type)
+    def impl(cls, key_type, value_type, n_keys=0):
+        return dictobject.new_dict(key_type, value_type, n_keys=n_keys)
+
+    return impl
+
+
+@overload_method(TypeRef, 'from_arrays')
+def typeddict_from_arrays(cls, keys, values):
+    if cls.instance_type is not DictType:
+        return
+    if not all(isinstance(a, types.Array) and a.ndim == 1
+               for a in (keys, values)):
+        raise errors.TypingError("from_arrays() expects two 1D arrays")
+
+    key_type, value_type = keys.dtype, values.dtype
+
+    def impl(cls, keys, values):
+        n = len(keys)
+        if len(values) != n:
+            raise ValueError("keys and values must have the same length")
+        d = dictobject.new_dict(key_type, value_type, n_keys=n)
+        for i in range(n):
+            d[keys[i]] = values[i]
+        return d
 
     return impl
 
@@ -10,6 +10,8 @@ it should really quack like the CPython `list`.
 """
 from collections.abc import MutableSequence
 
+import numpy as np
+
 from numba.core.types import ListType, TypeRef
 from numba.core.imputils import numba_typeref_ctor
 from numba.core.dispatcher import Dispatcher
@@ -166,6 +168,11 @@ def _sort(l, key, reverse):
     return l.sort(key, reverse)
 
 
+@njit
+def _asarray(l):
+    return l.asarray()
+
+
 def _from_meminfo_ptr(ptr, listtype):
     return List(meminfo=ptr, lsttype=listtype)
 
@@ -177,6 +184,8 @@ class List(MutableSequence):
     """
 
     _legal_kwargs = ["lsttype", "meminfo", "allocated"]
+    # The attribute holding the list type, read by the C dispatcher
+    _numba_type_attr_ = '_list_type'
 
     def __new__(cls,
                 lsttype=None,
@@ -238,6 +247,10 @@ class List(MutableSequence):
                 # NumPy Array.
                 if hasattr(iterable, "ndim") and iterable.ndim == 0:
                     self.append(iterable.item())
+                elif (isinstance(iterable, np.ndarray) and
+                        iterable.ndim == 1 and iterable.dtype.kind in 'biufc'):
+                    # Copy the items in a single call
+                    self.extend(iterable)
                 else:
                     try:
                         iter(iterable)
@@ -390,6 +403,36 @@ class List(MutableSequence):
             key = njit(key)
         return _sort(self, key, reverse)
 
+    def _is_buffer_compatible(self):
+        return (self._typed and
+                listobject._is_buffer_compatible(self._dtype))
+
+    def asarray(self):
+        """Return a Numpy array viewing the items of the list, without
+        copying them.  Only lists of numbers and booleans are supported.
+
+        The list cannot change size (e.g. with append() or pop()) while the
+        array or any view of it is alive; setting items is reflected in the
+        array.
+        """
+        if not self._is_buffer_compatible():
+            raise TypeError("asarray() needs a list of numbers or booleans")
+        return _asarray(self)
+
+    def __array__(self, dtype=None):
+        if self._is_buffer_compatible():
+            arr = self.asarray()
+        else:
+            arr = np.array(list(self))
+        return arr if dtype is None else arr.astype(dtype, copy=False)
+
+    def __buffer__(self, flags):
+        # The buffer protocol for Python 3.12+ (PEP 688)
+        if not self._is_buffer_compatible():
+            raise TypeError("a typed list of numbers or booleans is required "
+                            "to export a buffer")
+        return memoryview(self.asarray())
+
     def __str__(self):
         buf = []
         for x in self:
@@ -599,6 +642,13 @@ def impl_numba_typeref_ctor(cls, *args):
                 r = List.empty_list(item_type)
                 r.append(args[0].item())
                 return r
+        elif isinstance(args[0], types.Array) and args[0].ndim == 1:
+            def impl(cls, *args):
+                # Instatiate an empty list and extend it with the array,
+                # copying the items at once if possible.
+                r = List.empty_list(item_type)
+                r.extend(args[0])
+                return r
         else:
             def impl(cls, *args):
                 # Instatiate an empty list and populate it with values from the